@@ -1,5 +1,33 @@
 #include "autograd/value.hpp"
+#include "autograd/tensor.hpp"
 #include "autograd/graph_utils.hpp"
 namespace autograd {
     void backward(std::shared_ptr<Value> loss);
-}
\ No newline at end of file
+
+    // d loss / d inputs as graph nodes built from each op's vjp_fn, so they can be differentiated
+    // again (grad-of-grad). Nothing is written to the graph: the gradients only exist in the
+    // returned nodes, and an input the loss does not depend on gets a constant 0.
+    std::vector<std::shared_ptr<Value>> grad_graph(std::shared_ptr<Value> loss, const std::vector<std::shared_ptr<Value>>& inputs);
+
+    // Hessian-vector product H(loss) * v with respect to params, using grad_graph() plus one
+    // targeted pass over <grad, v>. Like grad(), it leaves every .grad as it was.
+    std::vector<double> hvp(std::shared_ptr<Value> loss, const std::vector<std::shared_ptr<Value>>& params, const std::vector<double>& v);
+
+    // Gradients of outputs (seeded with grad_outputs, default 1 each) with respect to inputs
+    // only, in one pass over the combined graph. Only nodes on a path from an output to a
+    // requested input run their grad_fn. The pass accumulates into its own GradStore, so no
+    // node's .grad is read or written and concurrent calls on one graph do not interfere.
+    // An input that does not influence the outputs gets 0.
+    std::vector<double> grad(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Value>>& inputs, const std::vector<double>& grad_outputs={});
+    // Same for whole tensors: one gradient vector per input tensor, laid out like its values.
+    std::vector<std::vector<double>> grad(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Tensor>>& inputs, const std::vector<double>& grad_outputs={});
+
+    // J[i][j] = d outputs[i] / d inputs[j]. The graph is sorted once and each row only runs the
+    // nodes its output reaches, so per-sample losses from one batched forward (outputs[b] =
+    // loss of sample b) give per-sample gradients without a separate backward() per sample.
+    // Like grad(), it leaves every .grad as it was.
+    // Cost: one pruned pass per row, O(outputs * reached graph). A matmul hub only multiplies
+    // the non-zero rows and columns of its output gradient, but still scans its outputs and
+    // operands once per row. For linear layers per_sample_linear_grads() needs a single pass.
+    std::vector<std::vector<double>> jacobian(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Value>>& inputs);
+}
@@ -1,5 +1,19 @@
+#pragma once
 #include "autograd/value.hpp"
 namespace autograd {
+    // Two kinds of scalar leaf. Everywhere else in the library (op-time folding, optimize_graph,
+    // expr::constant) "constant" means a leaf that is never differentiated.
+
+    // Fresh scalar leaf that is differentiated (requires_grad=true): a parameter or an input
+    // whose gradient is wanted. backward() accumulates into its .grad.
+    std::shared_ptr<Value> leaf(double v);
+
+    // Same as leaf(v). Despite the name the node does receive gradients; the name predates
+    // interned_constant() and is kept so existing code keeps working.
     std::shared_ptr<Value> constant(double v);
-    
+
+    // Constant that is never differentiated (requires_grad=false). Common scalars (0, 1, -1, 2,
+    // 0.5) come from a shared pool, so repeated calls return the same node; other values get a
+    // fresh leaf. Pooled nodes are shared across graphs and threads and must not be modified.
+    std::shared_ptr<Value> interned_constant(double v);
 }
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+// Compile-time front end for small, fixed scalar formulas. Expressions are built from
+// var<I>() placeholders with the usual operators; the whole formula is one nested type,
+// so evaluating it and its gradient inlines to straight-line code with no heap
+// allocation and no std::function. Gradients match the dynamic graph in ops.cpp,
+// including max() sending the gradient to its first argument on ties.
+//
+//   auto x = expr::var<0>();
+//   auto w = expr::var<1>();
+//   auto f = x * w + 5.0;
+//   std::array<double, 2> in{2.0, 3.0}, grad;
+//   double y = expr::value_and_grad(f, in, grad);   // y = 11, grad = {3, 2}
+//
+// Every node caches its forward value during evaluation, so one expression object should
+// not be evaluated from several threads at once; copies are cheap.
+namespace autograd {
+namespace expr {
+
+    template <class T> struct is_expr : std::false_type {};
+
+    template <int I>
+    struct Var {
+        mutable double v = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            static_assert(I >= 0 && (std::size_t)I < N, "expr::var index out of range");
+            v = x[I];
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            grad[I] += g;
+        }
+    };
+
+    struct Const {
+        double v;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>&) const { return v; }
+        template <std::size_t N>
+        void backprop(double, std::array<double, N>&) const {}
+    };
+
+    template <class L, class R>
+    struct Add {
+        L l; R r;
+        mutable double v = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            v = l.eval(x) + r.eval(x);
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            l.backprop(g, grad);
+            r.backprop(g, grad);
+        }
+    };
+
+    template <class L, class R>
+    struct Sub {
+        L l; R r;
+        mutable double v = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            v = l.eval(x) - r.eval(x);
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            l.backprop(g, grad);
+            r.backprop(-g, grad);
+        }
+    };
+
+    template <class L, class R>
+    struct Mul {
+        L l; R r;
+        mutable double v = 0.0, lv = 0.0, rv = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            lv = l.eval(x);
+            rv = r.eval(x);
+            v = lv * rv;
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            l.backprop(g * rv, grad);
+            r.backprop(g * lv, grad);
+        }
+    };
+
+    template <class L, class R>
+    struct Div {
+        L l; R r;
+        mutable double v = 0.0, lv = 0.0, rv = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            lv = l.eval(x);
+            rv = r.eval(x);
+            v = lv / rv;
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            l.backprop(g / rv, grad);
+            r.backprop(-g * lv / (rv * rv), grad);
+        }
+    };
+
+    template <class E>
+    struct Exp {
+        E e;
+        mutable double v = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            v = std::exp(e.eval(x));
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            e.backprop(g * v, grad);
+        }
+    };
+
+    template <class E>
+    struct Log {
+        E e;
+        mutable double v = 0.0, ev = 0.0;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            ev = e.eval(x);
+            v = std::log(ev);
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            e.backprop(g / ev, grad);
+        }
+    };
+
+    template <class L, class R>
+    struct Max {
+        L l; R r;
+        mutable double v = 0.0;
+        mutable bool left = true;
+
+        template <std::size_t N>
+        double eval(const std::array<double, N>& x) const {
+            double lv = l.eval(x);
+            double rv = r.eval(x);
+            left = lv >= rv;
+            v = left ? lv : rv;
+            return v;
+        }
+        template <std::size_t N>
+        void backprop(double g, std::array<double, N>& grad) const {
+            if (left) {
+                l.backprop(g, grad);
+            } else {
+                r.backprop(g, grad);
+            }
+        }
+    };
+
+    template <int I> struct is_expr<Var<I>> : std::true_type {};
+    template <> struct is_expr<Const> : std::true_type {};
+    template <class L, class R> struct is_expr<Add<L, R>> : std::true_type {};
+    template <class L, class R> struct is_expr<Sub<L, R>> : std::true_type {};
+    template <class L, class R> struct is_expr<Mul<L, R>> : std::true_type {};
+    template <class L, class R> struct is_expr<Div<L, R>> : std::true_type {};
+    template <class E> struct is_expr<Exp<E>> : std::true_type {};
+    template <class E> struct is_expr<Log<E>> : std::true_type {};
+    template <class L, class R> struct is_expr<Max<L, R>> : std::true_type {};
+
+    // Operands may be expressions or plain numbers; numbers become Const leaves.
+    template <class T>
+    using operand_t = std::conditional_t<is_expr<std::decay_t<T>>::value, std::decay_t<T>, Const>;
+
+    template <class T>
+    operand_t<T> as_operand(const T& t) {
+        if constexpr (is_expr<T>::value) {
+            return t;
+        } else {
+            return Const{(double)t};
+        }
+    }
+
+    template <class L, class R>
+    using enable_binary_t = std::enable_if_t<
+        (is_expr<std::decay_t<L>>::value || is_expr<std::decay_t<R>>::value) &&
+        (is_expr<std::decay_t<L>>::value || std::is_arithmetic<std::decay_t<L>>::value) &&
+        (is_expr<std::decay_t<R>>::value || std::is_arithmetic<std::decay_t<R>>::value)>;
+
+    template <int I>
+    constexpr Var<I> var() { return Var<I>{}; }
+
+    inline Const constant(double v) { return Const{v}; }
+
+    template <class L, class R, class = enable_binary_t<L, R>>
+    Add<operand_t<L>, operand_t<R>> operator+(const L& l, const R& r) { return {as_operand(l), as_operand(r)}; }
+
+    template <class L, class R, class = enable_binary_t<L, R>>
+    Sub<operand_t<L>, operand_t<R>> operator-(const L& l, const R& r) { return {as_operand(l), as_operand(r)}; }
+
+    template <class L, class R, class = enable_binary_t<L, R>>
+    Mul<operand_t<L>, operand_t<R>> operator*(const L& l, const R& r) { return {as_operand(l), as_operand(r)}; }
+
+    template <class L, class R, class = enable_binary_t<L, R>>
+    Div<operand_t<L>, operand_t<R>> operator/(const L& l, const R& r) { return {as_operand(l), as_operand(r)}; }
+
+    template <class L, class R, class = enable_binary_t<L, R>>
+    Max<operand_t<L>, operand_t<R>> max(const L& l, const R& r) { return {as_operand(l), as_operand(r)}; }
+
+    template <class E, class = std::enable_if_t<is_expr<E>::value>>
+    Exp<E> exp(const E& e) { return {e}; }
+
+    template <class E, class = std::enable_if_t<is_expr<E>::value>>
+    Log<E> log(const E& e) { return {e}; }
+
+    template <class E, class = std::enable_if_t<is_expr<E>::value>>
+    Max<E, Const> relu(const E& e) { return {e, Const{0.0}}; }
+
+    template <class E, std::size_t N>
+    double value(const E& e, const std::array<double, N>& x) {
+        return e.eval(x);
+    }
+
+    // Returns f(x) and overwrites grad with df/dx.
+    template <class E, std::size_t N>
+    double value_and_grad(const E& e, const std::array<double, N>& x, std::array<double, N>& grad) {
+        double v = e.eval(x);
+        grad.fill(0.0);
+        e.backprop(1.0, grad);
+        return v;
+    }
+
+} // namespace expr
+} // namespace autograd
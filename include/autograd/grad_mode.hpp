@@ -0,0 +1,18 @@
+#pragma once
+
+namespace autograd {
+    // Graph recording is a per-thread switch. While it is off, ops only compute values:
+    // outputs have no parents or backward rules and are marked requires_grad=false.
+    bool is_grad_enabled();
+    void set_grad_enabled(bool enabled);
+
+    // Turns recording off for the current thread until the guard goes out of scope.
+    struct NoGradGuard {
+        NoGradGuard();
+        ~NoGradGuard();
+        NoGradGuard(const NoGradGuard&) = delete;
+        NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+        bool previous;
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "autograd/value.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace autograd {
+    // Gradients of one backward pass kept beside the graph, keyed by node. While a store is
+    // active on a thread, backward rules accumulate into it instead of into each node's .grad,
+    // so a pass leaves the graph untouched and several passes can share one graph.
+    // With in_place, gradients stay in each node's .grad (backward()) and the store only holds
+    // the pass's hub buffers.
+    struct GradStore {
+        bool in_place = false;
+        std::unordered_map<const Value*, double> grads;
+        std::unordered_map<const Value*, std::vector<double>> hub_grads;
+    };
+
+    // The gradient backward rules on this thread accumulate into for v: its entry in the active
+    // store, or v->grad when none is active.
+    double& grad_ref(Value* v);
+
+    // Upstream gradients the outputs of a tensor-level op (matmul, a recurrent step) hand to
+    // their shared hub node. Each output's grad_fn adds into the hub's buffer in the active
+    // store, and the hub takes the buffer when it runs, so it only sees outputs its pass reached.
+    std::vector<double>& hub_grads(Value* hub, size_t size);
+    std::vector<double> take_hub_grads(Value* hub, size_t size);
+
+    // Makes store the active one for the current thread until the guard goes out of scope.
+    struct GradStoreGuard {
+        explicit GradStoreGuard(GradStore& store);
+        ~GradStoreGuard();
+        GradStoreGuard(const GradStoreGuard&) = delete;
+        GradStoreGuard& operator=(const GradStoreGuard&) = delete;
+
+        GradStore* previous;
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "autograd/value.hpp"
+#include "autograd/tensor.hpp"
+
+namespace autograd {
+    struct GradcheckOptions {
+        double eps = 1e-6;
+        double atol = 1e-5;
+        double rtol = 1e-3;
+
+        // Instead of perturbing every element, compare (f(x + eps v) - f(x - eps v)) / 2eps
+        // against <grad, v> for num_directions random unit vectors v per tensor.
+        bool directional = false;
+        int num_directions = 1;
+        unsigned seed = 0;
+
+        int num_threads = 0;    // 0 = the shared pool (see parallel.hpp)
+    };
+
+    struct GradcheckTensorReport {
+        size_t index;           // position in the inputs passed to gradcheck
+        int checked = 0;        // elements (or directions) compared
+        double max_abs_error = 0.0;
+        double max_rel_error = 0.0;
+        bool passed = true;
+    };
+
+    struct GradcheckReport {
+        std::vector<GradcheckTensorReport> tensors;
+        bool passed = true;
+    };
+
+    // fn must build its scalar loss only from the tensors it is given; it is called once with
+    // recording on for the analytic gradient and then from the thread pool (see parallel.hpp)
+    // on private copies of the inputs with recording off. Values with requires_grad=false are
+    // passed through but never perturbed, so a tensor without any trainable value is not
+    // checked. The inputs' values and grads are left as they were.
+    using GradcheckFn = std::function<std::shared_ptr<Value>(const std::vector<std::shared_ptr<Tensor>>&)>;
+    GradcheckReport gradcheck(GradcheckFn fn, const std::vector<std::shared_ptr<Tensor>>& inputs, GradcheckOptions options = {});
+}
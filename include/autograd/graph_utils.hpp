@@ -1,7 +1,24 @@
+#pragma once
 #include "autograd/value.hpp"
 #include <unordered_set>
 #include <vector>
 
 namespace autograd {
     void topSort(std::shared_ptr<Value> node, std::unordered_set<std::shared_ptr<Value>> &V, std::vector<std::shared_ptr<Value>> & topSortedNodes);
-}
\ No newline at end of file
+
+    struct GraphOptStats {
+        size_t nodes_before = 0;
+        size_t nodes_after = 0;
+        size_t folded = 0;          // nodes turned into constant leaves
+        size_t deduplicated = 0;    // nodes redirected to an identical earlier node
+    };
+
+    // Shrinks the graph below root in place before backward():
+    //  - a node whose parents are all constants (leaves with requires_grad=false) becomes a
+    //    constant leaf itself, which in turn lets its consumers fold;
+    //  - a node with the same op and the same inputs as an earlier one (add/mult in either
+    //    order) becomes an alias that forwards its gradient to that node, and its own
+    //    subgraph is released.
+    // Values and gradients are unchanged. Must not run while the graph is used elsewhere.
+    GraphOptStats optimize_graph(std::shared_ptr<Value> root);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "autograd/tensor.hpp"
+
+namespace autograd {
+    // ===== Graph-free model =====
+    // Plain numbers copied out of trained tensors; evaluating it never allocates Value nodes.
+    struct DenseLayer {
+        int in_features = 0;
+        int out_features = 0;
+        std::vector<double> weight;   // (out_features, in_features)
+        std::vector<double> bias;     // (out_features)
+        bool relu = false;
+    };
+
+    struct Model {
+        std::vector<DenseLayer> layers;
+        int input_size() const { return layers.empty() ? 0 : layers.front().in_features; }
+        int output_size() const { return layers.empty() ? 0 : layers.back().out_features; }
+    };
+
+    // W is (out, in) and b is (out, 1), laid out as for addBias(matmul(W, X), b).
+    DenseLayer dense_layer(std::shared_ptr<Tensor> W, std::shared_ptr<Tensor> b, bool relu=false);
+
+    // Text format: "layers <n>", then per layer "linear <in> <out> <relu|none>" followed by
+    // the out * in weights (row-major) and the out biases, whitespace separated.
+    Model load_model(const std::string& path);
+    void save_model(const Model& model, const std::string& path);
+
+    // x is (batch, input_size) row-major; returns (batch, output_size).
+    std::vector<double> forward_batch(const Model& model, const std::vector<double>& x, int batch);
+
+    // ===== Serving =====
+    struct EngineOptions {
+        int max_batch_size = 32;
+        // Longest a request waits for others to share its batch, measured from its arrival.
+        std::chrono::microseconds max_wait{500};
+    };
+
+    struct EngineStats {
+        uint64_t requests = 0;
+        uint64_t batches = 0;
+        double p50_latency_us = 0.0;   // submit() to result ready, over the most recent requests
+        double p99_latency_us = 0.0;
+        std::vector<uint64_t> batch_size_histogram;   // index = batch size
+    };
+
+    template <class T> class MpscQueue;
+
+    // Accepts requests from any number of threads through a lock-free queue. A single batching
+    // thread coalesces them into batches of at most max_batch_size, waiting at most max_wait
+    // after the oldest pending request, and runs one forward_batch per batch.
+    class InferenceEngine {
+    public:
+        // Throws std::invalid_argument for max_batch_size < 1 and for a model with no layers,
+        // a zero-sized layer, layers that do not chain or parameters of the wrong size.
+        explicit InferenceEngine(Model model, EngineOptions options = {});
+        ~InferenceEngine();   // finishes every request already submitted
+
+        InferenceEngine(const InferenceEngine&) = delete;
+        InferenceEngine& operator=(const InferenceEngine&) = delete;
+
+        std::future<std::vector<double>> submit(std::vector<double> input);
+        EngineStats stats() const;
+
+    private:
+        struct Request {
+            std::vector<double> input;
+            std::promise<std::vector<double>> result;
+            std::chrono::steady_clock::time_point arrival;
+        };
+
+        void run();
+        void run_batch(std::vector<std::unique_ptr<Request>>& batch);
+
+        Model model_;
+        EngineOptions options_;
+        std::unique_ptr<MpscQueue<std::unique_ptr<Request>>> queue_;
+
+        // Wake-up path for the batching thread; only touched when it is idle.
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        std::atomic<bool> sleeping_{false};
+        std::atomic<bool> stopping_{false};
+
+        mutable std::mutex stats_mutex_;
+        uint64_t requests_ = 0;
+        uint64_t batches_ = 0;
+        std::vector<uint64_t> batch_sizes_;
+        std::vector<double> latencies_us_;   // ring buffer of recent latencies
+        size_t latency_next_ = 0;
+
+        std::thread worker_;
+    };
+}
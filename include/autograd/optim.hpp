@@ -0,0 +1,12 @@
+#pragma once
+
+#include "autograd/tensor.hpp"
+#include "autograd/sparse.hpp"
+
+namespace autograd {
+    void zero_grad(std::shared_ptr<Tensor> param);
+    // Plain SGD: value -= learning_rate * grad, then the gradient is reset.
+    void sgd_step(std::shared_ptr<Tensor> param, double learning_rate);
+    // Sparse SGD: only rows looked up since the last step are updated and reset.
+    void sgd_step(std::shared_ptr<Embedding> table, double learning_rate);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace autograd {
+    // Size of the shared intra-op thread pool, including the calling thread. Defaults to the
+    // AUTOGRAD_NUM_THREADS environment variable, else std::thread::hardware_concurrency().
+    // 1 makes every parallel_for serial. Call before starting parallel work.
+    void set_num_threads(int num_threads);
+    int get_num_threads();
+
+    class ThreadPool;
+
+    // Runs this thread's parallel work on num_threads threads (including the caller) until the
+    // guard goes out of scope; other threads keep using the shared pool. num_threads <= 0, or
+    // the current size, changes nothing; any other size starts a private pool for the scope.
+    struct NumThreadsGuard {
+        explicit NumThreadsGuard(int num_threads);
+        ~NumThreadsGuard();
+        NumThreadsGuard(const NumThreadsGuard&) = delete;
+        NumThreadsGuard& operator=(const NumThreadsGuard&) = delete;
+
+        std::shared_ptr<ThreadPool> previous;
+    };
+
+    // Grain for GEMM-like loops (matmul, the recurrent gate GEMMs, dense layers): rows per
+    // parallel_for chunk so each chunk does roughly parallel_grain_flops multiply-adds.
+    constexpr int64_t parallel_grain_flops = 1 << 15;
+
+    inline int64_t rows_per_chunk(int64_t flops_per_row) {
+        return std::max<int64_t>(1, parallel_grain_flops / std::max<int64_t>(1, flops_per_row));
+    }
+
+    // Calls fn(chunk_begin, chunk_end) over disjoint chunks covering [begin, end), each at
+    // least grain_size long except possibly the last. Runs inline on the calling thread when
+    // the range is no larger than grain_size, when the pool has one thread, or when called
+    // from inside another parallel_for (nested regions never wait on the pool). Workers run
+    // with the caller's grad mode. The first exception thrown by fn is rethrown here.
+    void parallel_for(int64_t begin, int64_t end, int64_t grain_size, const std::function<void(int64_t, int64_t)>& fn);
+
+    // Reduces map(chunk_begin, chunk_end) over the same kind of chunks with combine. Chunk
+    // boundaries depend only on the range, grain and thread count, so results are reproducible.
+    template <class T, class Map, class Combine>
+    T parallel_reduce(int64_t begin, int64_t end, int64_t grain_size, T identity, const Map& map, const Combine& combine) {
+        if (end <= begin) {
+            return identity;
+        }
+        int64_t size = end - begin;
+        int64_t chunk = std::max<int64_t>(std::max<int64_t>(grain_size, 1), (size + get_num_threads() - 1) / get_num_threads());
+        int64_t num_chunks = (size + chunk - 1) / chunk;
+        auto partial = std::vector<T>(num_chunks, identity);
+        parallel_for(0, num_chunks, 1, [&](int64_t first, int64_t last) {
+            for (int64_t c = first; c < last; ++c) {
+                partial[c] = map(begin + c * chunk, std::min(end, begin + (c + 1) * chunk));
+            }
+        });
+        T result = identity;
+        for (auto& p : partial) {
+            result = combine(result, p);
+        }
+        return result;
+    }
+}
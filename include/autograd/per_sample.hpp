@@ -0,0 +1,27 @@
+#pragma once
+
+#include "autograd/tensor.hpp"
+
+namespace autograd {
+    // One linear layer Y = addBias(matmul(W, X), b) from a batched forward pass, where column j
+    // of X (in, batch) and of Y (out, batch) belongs to sample j.
+    struct LinearActivations {
+        std::shared_ptr<Tensor> X;
+        std::shared_ptr<Tensor> Y;
+    };
+
+    struct PerSampleLinearGrads {
+        int batch = 0;
+        int out_features = 0;
+        int in_features = 0;
+        std::vector<double> weight;   // (batch, out_features, in_features)
+        std::vector<double> bias;     // (batch, out_features)
+    };
+
+    // Per-sample gradients of W and b for each layer, where losses[j] depends on sample j only.
+    // One targeted backward pass over all losses gives dY; since column j of dY only comes from
+    // losses[j], the gradient of sample j is the outer product dY[:, j] X[:, j]^T (and dY[:, j]
+    // for the bias), so no per-sample graph is ever built. For other parameters use
+    // jacobian(losses, params) from backward.hpp. Leaves every .grad as it was.
+    std::vector<PerSampleLinearGrads> per_sample_linear_grads(const std::vector<std::shared_ptr<Value>>& losses, const std::vector<LinearActivations>& layers);
+}
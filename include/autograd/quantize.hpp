@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include "autograd/tensor.hpp"
+
+namespace autograd {
+    // Inference-only int8 path. Nothing here records a graph: outputs are plain numbers or
+    // leaf values with requires_grad=false.
+
+    enum class Int8Kernel { Scalar, AVX2, VNNI };
+
+    // Best kernel supported by the running CPU.
+    Int8Kernel detect_int8_kernel();
+    const char* int8_kernel_name(Int8Kernel kernel);
+
+    // C (M x N) = A (M x K) * W (N x K)^T with int8 inputs and int32 accumulation.
+    // K must be a multiple of 32 with both operands zero padded; w_row_sums[n] = sum_k W[n][k]
+    // (the VNNI kernel uses it to correct for feeding activations as unsigned bytes).
+    void int8_gemm(const int8_t* A, const int8_t* W, const int32_t* w_row_sums, int32_t* C, int M, int N, int K, Int8Kernel kernel);
+
+    // Post-training quantized version of y = W x + b (optionally followed by ReLU).
+    struct QuantizedLinear {
+        int in_features = 0;
+        int out_features = 0;
+        int padded_in = 0;                    // in_features rounded up to a multiple of 32
+
+        // ===== Weights: per output channel, symmetric =====
+        std::vector<int8_t> weight;           // (out_features, padded_in), zero padded
+        std::vector<float> weight_scale;      // W[o][k] ~= weight[o][k] * weight_scale[o]
+        std::vector<int32_t> weight_row_sum;
+
+        std::vector<float> bias;              // (out_features)
+        float input_scale = 1.0f;             // symmetric per-tensor activation scale from calibration
+        bool relu = false;
+    };
+
+    // weight is (out, in) and bias (out, 1), laid out as for addBias(matmul(weight, X), bias).
+    // calibration_inputs are sample activations of shape (in, batch) used to pick input_scale.
+    QuantizedLinear quantize_linear(std::shared_ptr<Tensor> weight, std::shared_ptr<Tensor> bias, const std::vector<std::shared_ptr<Tensor>>& calibration_inputs, bool relu=false);
+
+    // Quantizes float activations laid out (batch, in_features) into (batch, padded_in) int8.
+    std::vector<int8_t> quantize_input(const QuantizedLinear& layer, const std::vector<float>& x, int batch);
+
+    // x is (batch, in_features); returns (batch, out_features) with dequantize, bias and ReLU
+    // fused into the GEMM output stage.
+    std::vector<float> quantized_forward(const QuantizedLinear& layer, const std::vector<float>& x, int batch);
+    // Same for input that is already quantized, (batch, padded_in).
+    std::vector<float> quantized_forward(const QuantizedLinear& layer, const std::vector<int8_t>& x_q, int batch);
+
+    // Like quantized_forward, but the output stage requantizes to int8 with output_scale so the result can feed
+    // the next layer directly (its input_scale should equal output_scale). x_q comes from
+    // quantize_input or a previous layer and is (batch, padded_in); the result is
+    // (batch, next_padded) with next_padded = out_features rounded up to 32, zero padded.
+    std::vector<int8_t> quantized_forward_int8(const QuantizedLinear& layer, const std::vector<int8_t>& x_q, int batch, float output_scale);
+
+    // Tensor convenience: X is (in, batch) and the result (out, batch), both without a graph.
+    std::shared_ptr<Tensor> quantized_forward(const QuantizedLinear& layer, std::shared_ptr<Tensor> X);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include "autograd/tensor.hpp"
+
+namespace autograd {
+    // ===== Cells =====
+    // Each step computes every gate with one GEMM, z = W [x; h] + b, where x is
+    // (input_size, batch) and h is (hidden_size, batch).
+    struct RNNCell {
+        int input_size = 0;
+        int hidden_size = 0;
+        std::shared_ptr<Tensor> W;   // (H, input_size + H): [W_ih W_hh]
+        std::shared_ptr<Tensor> b;   // (H, 1)
+    };
+
+    struct LSTMCell {
+        int input_size = 0;
+        int hidden_size = 0;
+        std::shared_ptr<Tensor> W;   // (4H, input_size + H): rows for gates i, f, g, o
+        std::shared_ptr<Tensor> b;   // (4H, 1)
+    };
+
+    struct GRUCell {
+        int input_size = 0;
+        int hidden_size = 0;
+        // (4H, input_size + H) as blocks [[W_ir W_hr], [W_iz W_hz], [W_in 0], [0 W_hn]], so the
+        // candidate n = tanh(W_in x + b_in + r * (W_hn h + b_hn)) gets both of its halves from
+        // the same GEMM. The two zero blocks are never read and never receive a gradient.
+        std::shared_ptr<Tensor> W;
+        std::shared_ptr<Tensor> b;   // (4H, 1): b_r, b_z, b_in, b_hn
+    };
+
+    // Weights uniform in [-1/sqrt(H), 1/sqrt(H)]; the LSTM forget-gate bias starts at 1.
+    RNNCell rnn_cell(int input_size, int hidden_size, unsigned seed=0);
+    LSTMCell lstm_cell(int input_size, int hidden_size, unsigned seed=0);
+    GRUCell gru_cell(int input_size, int hidden_size, unsigned seed=0);
+
+    struct LSTMState {
+        std::shared_ptr<Tensor> h;   // (H, batch)
+        std::shared_ptr<Tensor> c;   // (H, batch)
+    };
+
+    std::shared_ptr<Tensor> rnn_zero_state(const RNNCell& cell, int batch);
+    LSTMState lstm_zero_state(const LSTMCell& cell, int batch);
+    std::shared_ptr<Tensor> gru_zero_state(const GRUCell& cell, int batch);
+
+    // One fused op per step: the new h (and c) hang off a single node whose backward is written
+    // by hand from the gate activations saved in the forward pass. There is no differentiable
+    // backward rule, so grad_graph() (and with it hvp()) through a step throws
+    // std::runtime_error. The plain RNN step is h' = tanh(W [x; h] + b).
+    std::shared_ptr<Tensor> rnn_step(const RNNCell& cell, std::shared_ptr<Tensor> x, std::shared_ptr<Tensor> h);
+    LSTMState lstm_step(const LSTMCell& cell, std::shared_ptr<Tensor> x, const LSTMState& state);
+    std::shared_ptr<Tensor> gru_step(const GRUCell& cell, std::shared_ptr<Tensor> x, std::shared_ptr<Tensor> h);
+
+    // ===== Truncated backpropagation through time =====
+    // Loss for step t given the new hidden state; nullptr when the step has no loss.
+    using StepLossFn = std::function<std::shared_ptr<Value>(int step, std::shared_ptr<Tensor> h)>;
+    // Called after each window's backward pass, e.g. for sgd_step and zero_grad.
+    using WindowEndFn = std::function<void(int first_step, int end_step, double window_loss)>;
+
+    // Runs the cell over inputs[0 .. T) in windows of `window` steps. Each window sums its step
+    // losses, runs one backward(), calls on_window_end and then detaches the state, so only one
+    // window's graph and saved activations are alive at a time. state is left at the final
+    // step; returns the sum of all step losses.
+    double truncated_bptt(const RNNCell& cell, const std::vector<std::shared_ptr<Tensor>>& inputs, std::shared_ptr<Tensor>& h, int window, const StepLossFn& step_loss, const WindowEndFn& on_window_end=nullptr);
+    double truncated_bptt(const LSTMCell& cell, const std::vector<std::shared_ptr<Tensor>>& inputs, LSTMState& state, int window, const StepLossFn& step_loss, const WindowEndFn& on_window_end=nullptr);
+    double truncated_bptt(const GRUCell& cell, const std::vector<std::shared_ptr<Tensor>>& inputs, std::shared_ptr<Tensor>& h, int window, const StepLossFn& step_loss, const WindowEndFn& on_window_end=nullptr);
+}
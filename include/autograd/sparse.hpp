@@ -0,0 +1,56 @@
+#pragma once
+
+#include "autograd/value.hpp"
+#include "autograd/tensor.hpp"
+
+namespace autograd {
+    // Coordinate format: one (row, col, value) triple per stored nonzero.
+    struct SparseCOO {
+        // ===== Nonzeros =====
+        std::vector<int> row_indices;
+        std::vector<int> col_indices;
+        std::vector<std::shared_ptr<Value>> values;
+
+        // ===== Shape =====
+        std::vector<int> shape;
+    };
+
+    // Compressed sparse row: the nonzeros of row i live in [row_ptr[i], row_ptr[i + 1]).
+    struct SparseCSR {
+        // ===== Nonzeros =====
+        std::vector<int> row_ptr;
+        std::vector<int> col_indices;
+        std::vector<std::shared_ptr<Value>> values;
+
+        // ===== Shape =====
+        std::vector<int> shape;
+    };
+
+    // Embedding table whose gradient is row-sparse: only rows that were looked up with grad
+    // mode on since the last optimizer step receive gradient and get updated.
+    struct Embedding {
+        std::shared_ptr<Tensor> weight;   // (num_embeddings, dim)
+        std::vector<int> touched_rows;    // may contain duplicates until the next step
+    };
+
+    // Row-sparse gradient: values holds rows.size() * dim entries, one dense row per index.
+    struct RowSparseGrad {
+        std::vector<int> rows;
+        std::vector<double> values;
+        int dim = 0;
+    };
+
+    std::shared_ptr<SparseCOO> create_sparse_coo(std::vector<int> row_indices, std::vector<int> col_indices, std::vector<float> data, int rows, int cols, bool requires_grad=true);
+    std::shared_ptr<SparseCOO> sparse_from_dense(std::shared_ptr<Tensor> A);
+    std::shared_ptr<SparseCSR> to_csr(std::shared_ptr<SparseCOO> A);
+    std::shared_ptr<SparseCOO> to_coo(std::shared_ptr<SparseCSR> A);
+
+    // Sparse x dense: work and graph size scale with nnz(a) * b.cols instead of rows * inner * cols.
+    std::shared_ptr<Tensor> matmul(std::shared_ptr<SparseCSR> a, std::shared_ptr<Tensor> b);
+    std::shared_ptr<Tensor> matmul(std::shared_ptr<SparseCOO> a, std::shared_ptr<Tensor> b);
+
+    std::shared_ptr<Embedding> create_embedding(std::vector<float> data, int num_embeddings, int dim);
+    // Returns an (ids.size(), dim) tensor that aliases the looked-up rows of the table (no new nodes).
+    std::shared_ptr<Tensor> embedding_lookup(std::shared_ptr<Embedding> table, const std::vector<int>& ids);
+    RowSparseGrad sparse_grad(std::shared_ptr<Embedding> table);
+}
@@ -13,4 +13,6 @@ namespace autograd {
     std::shared_ptr<Tensor> create_tensor(std::vector<float> data, int rows, int cols, bool requires_grad=true);
     std::vector<std::shared_ptr<Value>> create_matrix(std::vector<float> data, int rows, int cols, bool requires_grad=true);
     std::shared_ptr<Tensor> transpose(std::shared_ptr<Tensor> A);
+    // Same values as constant leaves (requires_grad=false), cut off from A's graph.
+    std::shared_ptr<Tensor> detach(std::shared_ptr<Tensor> A);
 }
\ No newline at end of file
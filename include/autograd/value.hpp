@@ -7,8 +7,13 @@
 \
 namespace autograd {
 
+    // Which op produced a node. Graph passes only fold or deduplicate the kinds they know;
+    // None covers leaves and anything built by hand or by tensor-level ops.
+    enum class Op { None, Add, Sub, Mult, Div, Exp, Log, Max, Alias };
+
     struct Value {
         Value() noexcept;   // ← THIS LINE IS REQUIRED
+        ~Value();
         // ===== Forward (primal) =====
         double value;  
 
@@ -21,7 +26,14 @@ namespace autograd {
         // ===== Local backward rule =====
         std::function<void()> grad_fn;
 
+        // ===== Differentiable backward rule (grad_graph) =====
+        // Same rule as grad_fn, but built out of ops: takes the upstream gradient as a node
+        // and returns one gradient node per parent (nullptr where no gradient flows).
+        std::function<std::vector<std::shared_ptr<Value>>(std::shared_ptr<Value>)> vjp_fn;
+
         bool requires_grad = true;
+
+        Op op = Op::None;
     };
 
 } // namespace autograd
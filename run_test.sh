@@ -14,6 +14,17 @@ EXECUTABLES=(
   test_nn
   test_bias
   test_finite_diff
+  test_sparse
+  test_higher_order
+  test_gradcheck
+  test_expr
+  test_quantize
+  test_inference
+  test_parallel
+  test_graph_opt
+  test_grad
+  test_per_sample
+  test_recurrent
 )
 # --------------------------------
 
@@ -3,8 +3,8 @@
 
 namespace autograd {
     std::shared_ptr<Value> relu(std::shared_ptr<Value> x) {
-        auto zero_value = constant(0.0);
-        auto out = max(x, zero_value);
+        // Shared zero from the constant pool instead of a new node per element.
+        auto out = max(x, interned_constant(0.0));
         return out;
     }
 }
\ No newline at end of file
@@ -1,7 +1,108 @@
 #include "autograd/backward.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/grad_store.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace autograd {
+    namespace {
+        void accumulate(std::shared_ptr<Value>& slot, std::shared_ptr<Value> g) {
+            slot = slot ? add(slot, g) : g;
+        }
+
+        // The part of the graph a targeted pass needs, found once for a set of outputs and inputs.
+        struct GradPlan {
+            std::vector<Value*> run;        // nodes on a path to a requested input, in backward order
+            std::vector<bool> reached;      // per input: part of the graph and differentiable
+        };
+
+        GradPlan make_plan(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Value>>& inputs) {
+            auto visited = std::unordered_set<std::shared_ptr<Value>>();
+            auto order = std::vector<std::shared_ptr<Value>>();
+            for (auto& output : outputs) {
+                topSort(output, visited, order);
+            }
+
+            // Parents come first in order, so one sweep finds every node that can reach an input.
+            auto needed = std::unordered_set<Value*>();
+            for (auto& input : inputs) {
+                needed.insert(input.get());
+            }
+            GradPlan plan;
+            for (auto& node : order) {
+                bool reaches = false;
+                for (auto& parent : node->parents) {
+                    if (needed.count(parent.get()) != 0) {
+                        reaches = true;
+                        break;
+                    }
+                }
+                if (!reaches) {
+                    continue;
+                }
+                needed.insert(node.get());
+                plan.run.push_back(node.get());
+            }
+            std::reverse(plan.run.begin(), plan.run.end());
+            for (auto& input : inputs) {
+                plan.reached.push_back(visited.count(input) != 0 && input->requires_grad);
+            }
+            return plan;
+        }
+
+        // One pass of the plan. Gradients go to a store private to the pass, so no node's .grad
+        // is read or written and stale gradients from earlier passes cannot leak in.
+        // With only_seeded, nodes that no output with a non-zero seed reaches are skipped too
+        // (a jacobian row seeds one output of many).
+        std::vector<double> run_plan(const GradPlan& plan, const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<double>& seeds, const std::vector<std::shared_ptr<Value>>& inputs, bool only_seeded=false) {
+            GradStore store;
+            GradStoreGuard guard(store);
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                if (outputs[i]->requires_grad) {
+                    grad_ref(outputs[i].get()) += seeds[i];
+                }
+            }
+            auto live = std::unordered_set<Value*>();
+            if (only_seeded) {
+                for (size_t i = 0; i < outputs.size(); ++i) {
+                    if (seeds[i] != 0.0) {
+                        live.insert(outputs[i].get());
+                    }
+                }
+            }
+            for (auto node : plan.run) {
+                if (only_seeded) {
+                    if (live.count(node) == 0) {
+                        continue;
+                    }
+                    for (auto& parent : node->parents) {
+                        live.insert(parent.get());
+                    }
+                }
+                if (node->grad_fn != nullptr) {
+                    node->grad_fn();
+                }
+            }
+            auto out = std::vector<double>(inputs.size(), 0.0);
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                if (plan.reached[i]) {
+                    out[i] = grad_ref(inputs[i].get());
+                }
+            }
+            return out;
+        }
+    }
+
     void backward(std::shared_ptr<Value> loss) {
+        if (!loss->requires_grad) {
+            return;
+        }
+        // Gradients stay in .grad; the store only carries this pass's hub buffers.
+        GradStore pass;
+        pass.in_place = true;
+        GradStoreGuard guard(pass);
         loss->grad = 1.0;
         auto vistedNodes = std::unordered_set<std::shared_ptr<Value>>();
         auto topoOrder = std::vector<std::shared_ptr<Value>>();
@@ -13,4 +114,91 @@ namespace autograd {
             }  
         }
     }
+
+    std::vector<std::shared_ptr<Value>> grad_graph(std::shared_ptr<Value> loss, const std::vector<std::shared_ptr<Value>>& inputs) {
+        auto plan = make_plan({loss}, inputs);
+
+        // Gradients only live in this map, keyed by node; no node is written, so the returned
+        // graphs hold no reference back into the graph they differentiate.
+        auto grads = std::unordered_map<Value*, std::shared_ptr<Value>>();
+        if (loss->requires_grad) {
+            grads[loss.get()] = interned_constant(1.0);
+        }
+        for (auto node : plan.run) {
+            auto found = grads.find(node);
+            if (found == grads.end()) {
+                continue;
+            }
+            if (node->vjp_fn == nullptr) {
+                throw std::runtime_error("grad_graph: op has no differentiable backward rule");
+            }
+            auto parent_grads = node->vjp_fn(found->second);
+            for (size_t i = 0; i < node->parents.size(); ++i) {
+                if (parent_grads[i] != nullptr) {
+                    accumulate(grads[node->parents[i].get()], parent_grads[i]);
+                }
+            }
+        }
+        auto out = std::vector<std::shared_ptr<Value>>(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            auto found = grads.find(inputs[i].get());
+            out[i] = plan.reached[i] && found != grads.end() ? found->second : interned_constant(0.0);
+        }
+        return out;
+    }
+
+    std::vector<double> hvp(std::shared_ptr<Value> loss, const std::vector<std::shared_ptr<Value>>& params, const std::vector<double>& v) {
+        if (params.size() != v.size()) {
+            throw std::invalid_argument("hvp: params and v must have the same length");
+        }
+        auto g = grad_graph(loss, params);
+
+        // <grad(loss), v> as a scalar node; differentiating it once more gives H v.
+        std::shared_ptr<Value> gv = nullptr;
+        for (size_t i = 0; i < params.size(); ++i) {
+            if (v[i] != 0.0) {
+                accumulate(gv, mult(g[i], interned_constant(v[i])));
+            }
+        }
+        if (gv == nullptr) {
+            return std::vector<double>(params.size(), 0.0);
+        }
+        return grad({gv}, params);
+    }
+
+    std::vector<double> grad(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Value>>& inputs, const std::vector<double>& grad_outputs) {
+        if (!grad_outputs.empty() && grad_outputs.size() != outputs.size()) {
+            throw std::invalid_argument("grad: grad_outputs must be empty or match outputs");
+        }
+        auto seeds = grad_outputs.empty() ? std::vector<double>(outputs.size(), 1.0) : grad_outputs;
+        return run_plan(make_plan(outputs, inputs), outputs, seeds, inputs);
+    }
+
+    std::vector<std::vector<double>> grad(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Tensor>>& inputs, const std::vector<double>& grad_outputs) {
+        auto flat = std::vector<std::shared_ptr<Value>>();
+        for (auto& tensor : inputs) {
+            flat.insert(flat.end(), tensor->values.begin(), tensor->values.end());
+        }
+        auto grads = grad(outputs, flat, grad_outputs);
+        auto out = std::vector<std::vector<double>>();
+        size_t offset = 0;
+        for (auto& tensor : inputs) {
+            out.emplace_back(grads.begin() + offset, grads.begin() + offset + tensor->values.size());
+            offset += tensor->values.size();
+        }
+        return out;
+    }
+
+    std::vector<std::vector<double>> jacobian(const std::vector<std::shared_ptr<Value>>& outputs, const std::vector<std::shared_ptr<Value>>& inputs) {
+        auto plan = make_plan(outputs, inputs);
+        auto rows = std::vector<std::vector<double>>();
+        rows.reserve(outputs.size());
+        auto seeds = std::vector<double>(outputs.size(), 0.0);
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            seeds[i] = 1.0;
+            rows.push_back(run_plan(plan, outputs, seeds, inputs, true));
+            seeds[i] = 0.0;
+        }
+        return rows;
+    }
 }
@@ -1,12 +1,48 @@
 #include "autograd/constant.hpp"
+#include <cmath>
 
 namespace autograd {
-    std::shared_ptr<Value> constant(double v) {
+    namespace {
+        // Built once and only ever read afterwards: no op writes a gradient into a node with
+        // requires_grad=false, so the pool needs no locking.
+        const std::vector<std::shared_ptr<Value>>& constant_pool() {
+            static const auto pool = [] {
+                auto nodes = std::vector<std::shared_ptr<Value>>();
+                for (double v : {0.0, 1.0, -1.0, 2.0, 0.5}) {
+                    auto node = std::make_shared<Value>();
+                    node->value = v;
+                    node->requires_grad = false;
+                    nodes.push_back(node);
+                }
+                return nodes;
+            }();
+            return pool;
+        }
+    }
+
+    std::shared_ptr<Value> leaf(double v) {
         auto out = std::make_shared<Value>();
         out->value = v;
         out->grad = 0.0;
-        // No parents since it's a constant
-        out->grad_fn = nullptr; // No gradient function for constants
+        // No parents since it's a leaf
+        out->grad_fn = nullptr; // No gradient function for leaves
+        return out;
+    }
+
+    std::shared_ptr<Value> constant(double v) {
+        return leaf(v);
+    }
+
+    std::shared_ptr<Value> interned_constant(double v) {
+        for (auto& node : constant_pool()) {
+            // -0.0 compares equal to 0.0 but is not interchangeable with it (1 / -0.0).
+            if (node->value == v && std::signbit(node->value) == std::signbit(v)) {
+                return node;
+            }
+        }
+        auto out = std::make_shared<Value>();
+        out->value = v;
+        out->requires_grad = false;
         return out;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,23 @@
+#include "autograd/grad_mode.hpp"
+
+namespace autograd {
+    namespace {
+        thread_local bool grad_enabled = true;
+    }
+
+    bool is_grad_enabled() {
+        return grad_enabled;
+    }
+
+    void set_grad_enabled(bool enabled) {
+        grad_enabled = enabled;
+    }
+
+    NoGradGuard::NoGradGuard() : previous(grad_enabled) {
+        grad_enabled = false;
+    }
+
+    NoGradGuard::~NoGradGuard() {
+        grad_enabled = previous;
+    }
+}
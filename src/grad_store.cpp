@@ -0,0 +1,44 @@
+#include "autograd/grad_store.hpp"
+
+namespace autograd {
+    namespace {
+        thread_local GradStore* active_store = nullptr;
+        // Hub buffers of rules run outside backward() and grad(), e.g. by hand.
+        thread_local GradStore fallback_store;
+
+        GradStore& hub_store() {
+            return active_store != nullptr ? *active_store : fallback_store;
+        }
+    }
+
+    double& grad_ref(Value* v) {
+        return active_store != nullptr && !active_store->in_place ? active_store->grads[v] : v->grad;
+    }
+
+    std::vector<double>& hub_grads(Value* hub, size_t size) {
+        auto& buffer = hub_store().hub_grads[hub];
+        if (buffer.empty()) {
+            buffer.assign(size, 0.0);
+        }
+        return buffer;
+    }
+
+    std::vector<double> take_hub_grads(Value* hub, size_t size) {
+        auto& buffers = hub_store().hub_grads;
+        auto found = buffers.find(hub);
+        if (found == buffers.end()) {
+            return std::vector<double>(size, 0.0);
+        }
+        auto buffer = std::move(found->second);
+        buffers.erase(found);
+        return buffer;
+    }
+
+    GradStoreGuard::GradStoreGuard(GradStore& store) : previous(active_store) {
+        active_store = &store;
+    }
+
+    GradStoreGuard::~GradStoreGuard() {
+        active_store = previous;
+    }
+}
@@ -0,0 +1,163 @@
+#include "autograd/gradcheck.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace autograd {
+    namespace {
+        // One perturbed comparison: element `element` of tensor `tensor`, or direction `direction`.
+        struct Probe {
+            size_t tensor;
+            int element;
+            int direction;
+            double analytic;
+            double numeric;
+        };
+
+        std::vector<std::shared_ptr<Tensor>> clone_inputs(const std::vector<std::shared_ptr<Tensor>>& inputs) {
+            auto copies = std::vector<std::shared_ptr<Tensor>>();
+            for (auto& t : inputs) {
+                auto copy = std::make_shared<Tensor>();
+                copy->shape = t->shape;
+                for (auto& v : t->values) {
+                    auto val = std::make_shared<Value>();
+                    val->value = v->value;
+                    val->requires_grad = false;
+                    copy->values.push_back(val);
+                }
+                copies.push_back(copy);
+            }
+            return copies;
+        }
+
+        bool is_checked(const std::shared_ptr<Tensor>& t) {
+            return std::any_of(t->values.begin(), t->values.end(), [](const std::shared_ptr<Value>& v) { return v->requires_grad; });
+        }
+    }
+
+    GradcheckReport gradcheck(GradcheckFn fn, const std::vector<std::shared_ptr<Tensor>>& inputs, GradcheckOptions options) {
+        // ===== Analytic gradients =====
+        auto saved_grads = std::vector<std::vector<double>>();
+        for (auto& t : inputs) {
+            auto grads = std::vector<double>();
+            for (auto& v : t->values) {
+                grads.push_back(v->grad);
+                v->grad = 0.0;
+            }
+            saved_grads.push_back(grads);
+        }
+        backward(fn(inputs));
+        auto analytic = std::vector<std::vector<double>>();
+        for (size_t t = 0; t < inputs.size(); ++t) {
+            auto grads = std::vector<double>();
+            for (size_t i = 0; i < inputs[t]->values.size(); ++i) {
+                grads.push_back(inputs[t]->values[i]->grad);
+                inputs[t]->values[i]->grad = saved_grads[t][i];
+            }
+            analytic.push_back(grads);
+        }
+
+        // ===== Probes (directions drawn up front so results do not depend on scheduling) =====
+        auto probes = std::vector<Probe>();
+        auto directions = std::vector<std::vector<std::vector<double>>>(inputs.size());
+        std::mt19937 rng(options.seed);
+        std::normal_distribution<double> normal(0.0, 1.0);
+        for (size_t t = 0; t < inputs.size(); ++t) {
+            if (!is_checked(inputs[t])) {
+                continue;
+            }
+            // Elements with requires_grad=false get no analytic gradient, so they are never
+            // perturbed: no probe of their own, and a zero entry in every direction.
+            auto& values = inputs[t]->values;
+            int size = (int)values.size();
+            if (!options.directional) {
+                for (int i = 0; i < size; ++i) {
+                    if (values[i]->requires_grad) {
+                        probes.push_back(Probe{t, i, -1, analytic[t][i], 0.0});
+                    }
+                }
+                continue;
+            }
+            for (int d = 0; d < options.num_directions; ++d) {
+                auto v = std::vector<double>(size);
+                double norm = 0.0;
+                for (int i = 0; i < size; ++i) {
+                    v[i] = normal(rng);
+                    if (!values[i]->requires_grad) {
+                        v[i] = 0.0;
+                    }
+                    norm += v[i] * v[i];
+                }
+                norm = std::sqrt(norm);
+                double dot = 0.0;
+                for (int i = 0; i < size; ++i) {
+                    v[i] /= norm;
+                    dot += analytic[t][i] * v[i];
+                }
+                directions[t].push_back(v);
+                probes.push_back(Probe{t, -1, d, dot, 0.0});
+            }
+        }
+
+        // ===== Perturbed forward passes on the pool, no graph, one input copy per chunk =====
+        NumThreadsGuard threads(options.num_threads);
+        parallel_for(0, (int64_t)probes.size(), 1, [&](int64_t first, int64_t last) {
+            NoGradGuard no_grad;
+            auto local = clone_inputs(inputs);
+            for (int64_t n = first; n < last; ++n) {
+                auto& probe = probes[n];
+                auto& values = local[probe.tensor]->values;
+                auto perturbed_loss = [&](double step) {
+                    if (probe.direction < 0) {
+                        double original = values[probe.element]->value;
+                        values[probe.element]->value = original + step;
+                        double loss = fn(local)->value;
+                        values[probe.element]->value = original;
+                        return loss;
+                    }
+                    auto& v = directions[probe.tensor][probe.direction];
+                    auto originals = std::vector<double>();
+                    for (size_t i = 0; i < values.size(); ++i) {
+                        originals.push_back(values[i]->value);
+                        values[i]->value += step * v[i];
+                    }
+                    double loss = fn(local)->value;
+                    for (size_t i = 0; i < values.size(); ++i) {
+                        values[i]->value = originals[i];
+                    }
+                    return loss;
+                };
+                probe.numeric = (perturbed_loss(options.eps) - perturbed_loss(-options.eps)) / (2.0 * options.eps);
+            }
+        });
+
+        // ===== Report =====
+        GradcheckReport report;
+        auto slot = std::vector<int>(inputs.size(), -1);
+        for (size_t t = 0; t < inputs.size(); ++t) {
+            if (is_checked(inputs[t])) {
+                slot[t] = (int)report.tensors.size();
+                GradcheckTensorReport entry;
+                entry.index = t;
+                report.tensors.push_back(entry);
+            }
+        }
+        for (auto& probe : probes) {
+            auto& entry = report.tensors[slot[probe.tensor]];
+            double abs_error = std::abs(probe.analytic - probe.numeric);
+            double scale = std::max(std::abs(probe.analytic), std::abs(probe.numeric));
+            double rel_error = scale > 0.0 ? abs_error / scale : 0.0;
+            entry.checked++;
+            entry.max_abs_error = std::max(entry.max_abs_error, abs_error);
+            entry.max_rel_error = std::max(entry.max_rel_error, rel_error);
+            if (abs_error > options.atol + options.rtol * std::abs(probe.numeric)) {
+                entry.passed = false;
+                report.passed = false;
+            }
+        }
+        return report;
+    }
+}
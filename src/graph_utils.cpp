@@ -1,21 +1,131 @@
 #include "autograd/graph_utils.hpp"
+#include "autograd/grad_store.hpp"
+#include <functional>
+#include <unordered_map>
+#include <utility>
 
 namespace autograd {
+    namespace {
+        // Structural identity of a pure op: its kind and its (alias-resolved) inputs.
+        struct NodeKey {
+            Op op;
+            Value* a;
+            Value* b;
+            bool operator==(const NodeKey& other) const {
+                return op == other.op && a == other.a && b == other.b;
+            }
+        };
+
+        struct NodeKeyHash {
+            size_t operator()(const NodeKey& key) const {
+                size_t h = std::hash<Value*>()(key.a);
+                h ^= std::hash<Value*>()(key.b) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+                return h ^ (size_t)key.op;
+            }
+        };
+
+        bool is_constant(const std::shared_ptr<Value>& v) {
+            return !v->requires_grad && v->parents.empty();
+        }
+
+        // Only the scalar ops from ops.cpp are known to be pure functions of their parents;
+        // hubs, sparse nodes and hand-built nodes are left alone.
+        bool is_pure(Op op) {
+            return op != Op::None && op != Op::Alias;
+        }
+
+        Value* resolve(Value* v) {
+            return v->op == Op::Alias ? v->parents[0].get() : v;
+        }
+
+        void fold(const std::shared_ptr<Value>& node) {
+            node->parents.clear();
+            node->grad_fn = nullptr;
+            node->vjp_fn = nullptr;
+            node->requires_grad = false;
+            node->op = Op::None;
+        }
+
+        void make_alias(const std::shared_ptr<Value>& node, std::shared_ptr<Value> target) {
+            node->parents = {std::move(target)};
+            node->op = Op::Alias;
+            auto raw = node.get();
+            node->grad_fn = [raw]() {
+                grad_ref(raw->parents[0].get()) += grad_ref(raw);
+            };
+            node->vjp_fn = [](std::shared_ptr<Value> g) {
+                return std::vector<std::shared_ptr<Value>>{g};
+            };
+        }
+    }
+
     void topSort(std::shared_ptr<Value> node, std::unordered_set<std::shared_ptr<Value>> &V, std::vector<std::shared_ptr<Value>> & topSortedNodes) {
         if (V.find(node) != V.end()) {
             return;
         }
-        if (node->parents.empty() ) {
-            V.insert(node);
-            topSortedNodes.push_back(node);
-            return;
+        // Depth-first with an explicit stack (node, next parent to visit): an unrolled sequence
+        // is far deeper than the call stack. Emits the same order as the recursive version.
+        auto stack = std::vector<std::pair<std::shared_ptr<Value>, size_t>>();
+        V.insert(node);
+        stack.emplace_back(node, 0);
+        while (!stack.empty()) {
+            auto current = stack.back().first;
+            size_t next = stack.back().second;
+            if (next < current->parents.size()) {
+                stack.back().second += 1;
+                auto& parent = current->parents[next];
+                if (V.insert(parent).second) {
+                    stack.emplace_back(parent, 0);
+                }
+                continue;
+            }
+            topSortedNodes.push_back(current);
+            stack.pop_back();
         }
-        for (auto parent : node->parents) {
-            if (V.find(parent) == V.end()) {
-                topSort(parent, V, topSortedNodes);
+    }
+
+    GraphOptStats optimize_graph(std::shared_ptr<Value> root) {
+        GraphOptStats stats;
+        auto visited = std::unordered_set<std::shared_ptr<Value>>();
+        auto order = std::vector<std::shared_ptr<Value>>();
+        topSort(root, visited, order);
+        stats.nodes_before = order.size();
+
+        // Parents come before children, so by the time a node is looked at its inputs have
+        // already been folded or redirected.
+        auto seen = std::unordered_map<NodeKey, std::shared_ptr<Value>, NodeKeyHash>();
+        for (auto& node : order) {
+            if (node->parents.empty()) {
+                continue;
+            }
+            bool all_constant = true;
+            for (auto& parent : node->parents) {
+                all_constant = all_constant && is_constant(parent);
+            }
+            if (all_constant) {
+                fold(node);
+                stats.folded += 1;
+                continue;
+            }
+            if (!is_pure(node->op)) {
+                continue;
+            }
+            auto a = resolve(node->parents[0].get());
+            auto b = node->parents.size() > 1 ? resolve(node->parents[1].get()) : nullptr;
+            if ((node->op == Op::Add || node->op == Op::Mult) && std::less<Value*>()(b, a)) {
+                std::swap(a, b);
+            }
+            auto found = seen.emplace(NodeKey{node->op, a, b}, node);
+            if (!found.second) {
+                make_alias(node, found.first->second);
+                stats.deduplicated += 1;
             }
         }
-        V.insert(node);
-        topSortedNodes.push_back(node);
+
+        visited.clear();
+        order.clear();
+        topSort(root, visited, order);
+        stats.nodes_after = order.size();
+        return stats;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,269 @@
+#include "autograd/inference.hpp"
+#include "autograd/parallel.hpp"
+#include "mpsc_queue.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace autograd {
+    namespace {
+        const size_t latency_window = 1 << 16;
+
+        double percentile(std::vector<double> samples, double q) {
+            if (samples.empty()) {
+                return 0.0;
+            }
+            auto rank = (size_t)(q * (samples.size() - 1));
+            std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+            return samples[rank];
+        }
+
+        // A model the batching thread can run: every request must get a non-empty result,
+        // or its promise would never be set.
+        void check_model(const Model& model) {
+            if (model.layers.empty()) {
+                throw std::invalid_argument("InferenceEngine: model has no layers");
+            }
+            for (size_t l = 0; l < model.layers.size(); ++l) {
+                auto& layer = model.layers[l];
+                if (layer.in_features < 1 || layer.out_features < 1) {
+                    throw std::invalid_argument("InferenceEngine: layer sizes must be at least 1");
+                }
+                if (l > 0 && model.layers[l - 1].out_features != layer.in_features) {
+                    throw std::invalid_argument("InferenceEngine: layer sizes do not chain");
+                }
+                if (layer.weight.size() != (size_t)layer.out_features * layer.in_features || layer.bias.size() != (size_t)layer.out_features) {
+                    throw std::invalid_argument("InferenceEngine: layer parameters do not match its sizes");
+                }
+            }
+        }
+    }
+
+    DenseLayer dense_layer(std::shared_ptr<Tensor> W, std::shared_ptr<Tensor> b, bool relu) {
+        if (b->shape[0] != W->shape[0]) {
+            throw std::invalid_argument("Incompatible tensor shapes for dense_layer");
+        }
+        DenseLayer layer;
+        layer.out_features = W->shape[0];
+        layer.in_features = W->shape[1];
+        layer.relu = relu;
+        for (auto& v : W->values) {
+            layer.weight.push_back(v->value);
+        }
+        for (int o = 0; o < layer.out_features; ++o) {
+            layer.bias.push_back(b->values[o]->value);
+        }
+        return layer;
+    }
+
+    Model load_model(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("Cannot open model file " + path);
+        }
+        std::string tag;
+        int num_layers = 0;
+        if (!(in >> tag >> num_layers) || tag != "layers") {
+            throw std::runtime_error("Model file must start with 'layers <n>'");
+        }
+        Model model;
+        for (int l = 0; l < num_layers; ++l) {
+            DenseLayer layer;
+            std::string activation;
+            if (!(in >> tag >> layer.in_features >> layer.out_features >> activation) || tag != "linear") {
+                throw std::runtime_error("Expected 'linear <in> <out> <relu|none>' in model file");
+            }
+            if (!model.layers.empty() && model.layers.back().out_features != layer.in_features) {
+                throw std::runtime_error("Layer sizes in model file do not chain");
+            }
+            layer.relu = activation == "relu";
+            layer.weight.resize((size_t)layer.out_features * layer.in_features);
+            layer.bias.resize(layer.out_features);
+            for (auto& w : layer.weight) {
+                in >> w;
+            }
+            for (auto& b : layer.bias) {
+                in >> b;
+            }
+            if (!in) {
+                throw std::runtime_error("Model file ended before all parameters were read");
+            }
+            model.layers.push_back(std::move(layer));
+        }
+        return model;
+    }
+
+    void save_model(const Model& model, const std::string& path) {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Cannot write model file " + path);
+        }
+        out.precision(17);
+        out << "layers " << model.layers.size() << "\n";
+        for (auto& layer : model.layers) {
+            out << "linear " << layer.in_features << " " << layer.out_features << " " << (layer.relu ? "relu" : "none") << "\n";
+            for (auto w : layer.weight) {
+                out << w << " ";
+            }
+            out << "\n";
+            for (auto b : layer.bias) {
+                out << b << " ";
+            }
+            out << "\n";
+        }
+    }
+
+    std::vector<double> forward_batch(const Model& model, const std::vector<double>& x, int batch) {
+        if ((int)x.size() != batch * model.input_size()) {
+            throw std::invalid_argument("forward_batch: expected batch * input_size values");
+        }
+        auto current = x;
+        for (auto& layer : model.layers) {
+            auto next = std::vector<double>((size_t)batch * layer.out_features);
+            // Split over output features so a single large request still uses every core.
+            parallel_for(0, layer.out_features, rows_per_chunk((int64_t)layer.in_features * batch), [&](int64_t first, int64_t last) {
+                for (int m = 0; m < batch; ++m) {
+                    const double* in = current.data() + (size_t)m * layer.in_features;
+                    for (int64_t o = first; o < last; ++o) {
+                        const double* w = layer.weight.data() + (size_t)o * layer.in_features;
+                        double sum = layer.bias[o];
+                        for (int k = 0; k < layer.in_features; ++k) {
+                            sum += w[k] * in[k];
+                        }
+                        next[(size_t)m * layer.out_features + o] = layer.relu ? std::max(0.0, sum) : sum;
+                    }
+                }
+            });
+            current = std::move(next);
+        }
+        return current;
+    }
+
+    InferenceEngine::InferenceEngine(Model model, EngineOptions options)
+        : model_(std::move(model)),
+          options_(options),
+          queue_(std::make_unique<MpscQueue<std::unique_ptr<Request>>>()),
+          batch_sizes_(std::max(1, options.max_batch_size) + 1, 0) {
+        if (options_.max_batch_size < 1) {
+            throw std::invalid_argument("max_batch_size must be at least 1");
+        }
+        check_model(model_);
+        latencies_us_.reserve(latency_window);
+        worker_ = std::thread(&InferenceEngine::run, this);
+    }
+
+    InferenceEngine::~InferenceEngine() {
+        stopping_ = true;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_.notify_one();
+        }
+        worker_.join();
+    }
+
+    std::future<std::vector<double>> InferenceEngine::submit(std::vector<double> input) {
+        auto request = std::make_unique<Request>();
+        auto future = request->result.get_future();
+        if ((int)input.size() != model_.input_size()) {
+            request->result.set_exception(std::make_exception_ptr(std::invalid_argument("Request size does not match the model input size")));
+            return future;
+        }
+        request->input = std::move(input);
+        request->arrival = std::chrono::steady_clock::now();
+        queue_->push(std::move(request));
+        // Only pay for the mutex when the batching thread is actually asleep.
+        if (sleeping_) {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            wake_.notify_one();
+        }
+        return future;
+    }
+
+    EngineStats InferenceEngine::stats() const {
+        EngineStats out;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        out.requests = requests_;
+        out.batches = batches_;
+        out.batch_size_histogram = batch_sizes_;
+        out.p50_latency_us = percentile(latencies_us_, 0.50);
+        out.p99_latency_us = percentile(latencies_us_, 0.99);
+        return out;
+    }
+
+    void InferenceEngine::run() {
+        auto batch = std::vector<std::unique_ptr<Request>>();
+        batch.reserve(options_.max_batch_size);
+        auto wait_until = [&](std::chrono::steady_clock::time_point deadline) {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            sleeping_ = true;
+            wake_.wait_until(lock, deadline, [&] { return !queue_->empty() || stopping_; });
+            sleeping_ = false;
+        };
+
+        while (true) {
+            std::unique_ptr<Request> request;
+            if (!queue_->pop(request)) {
+                if (stopping_) {
+                    break;
+                }
+                wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+                continue;
+            }
+
+            auto deadline = request->arrival + options_.max_wait;
+            batch.push_back(std::move(request));
+            while ((int)batch.size() < options_.max_batch_size) {
+                if (queue_->pop(request)) {
+                    batch.push_back(std::move(request));
+                    continue;
+                }
+                if (stopping_ || std::chrono::steady_clock::now() >= deadline) {
+                    break;
+                }
+                wait_until(deadline);
+            }
+            run_batch(batch);
+            batch.clear();
+        }
+    }
+
+    void InferenceEngine::run_batch(std::vector<std::unique_ptr<Request>>& batch) {
+        int n = (int)batch.size();
+        int in = model_.input_size();
+        int out = model_.output_size();
+        auto x = std::vector<double>((size_t)n * in);
+        for (int m = 0; m < n; ++m) {
+            std::copy(batch[m]->input.begin(), batch[m]->input.end(), x.begin() + (size_t)m * in);
+        }
+
+        std::vector<double> y;
+        try {
+            y = forward_batch(model_, x, n);
+        } catch (...) {
+            for (auto& request : batch) {
+                request->result.set_exception(std::current_exception());
+            }
+            y.clear();
+        }
+        if (!y.empty()) {
+            for (int m = 0; m < n; ++m) {
+                batch[m]->result.set_value(std::vector<double>(y.begin() + (size_t)m * out, y.begin() + (size_t)(m + 1) * out));
+            }
+        }
+
+        auto done = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        requests_ += n;
+        batches_ += 1;
+        batch_sizes_[n] += 1;
+        for (auto& request : batch) {
+            double us = std::chrono::duration<double, std::micro>(done - request->arrival).count();
+            if (latencies_us_.size() < latency_window) {
+                latencies_us_.push_back(us);
+            } else {
+                latencies_us_[latency_next_] = us;
+                latency_next_ = (latency_next_ + 1) % latency_window;
+            }
+        }
+    }
+}
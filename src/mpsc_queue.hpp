@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace autograd {
+    // Lock-free multi-producer / single-consumer queue (Vyukov's intrusive node queue).
+    // push() may be called from any thread; pop() and empty() only from the one consumer.
+    // A producer that has swapped the head but not linked its node yet makes the queue look
+    // empty for a moment, which only delays that item until the next pop().
+    template <class T>
+    class MpscQueue {
+    public:
+        MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+        ~MpscQueue() {
+            T discard;
+            while (pop(discard)) {
+            }
+            if (tail_ != &stub_) {
+                delete tail_;
+            }
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        void push(T value) {
+            auto node = new Node();
+            node->value = std::move(value);
+            Node* prev = head_.exchange(node);
+            prev->next.store(node);
+        }
+
+        bool pop(T& out) {
+            Node* tail = tail_;
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return false;
+            }
+            out = std::move(next->value);
+            tail_ = next;
+            if (tail != &stub_) {
+                delete tail;
+            }
+            return true;
+        }
+
+        // Sequentially consistent so a consumer that publishes "going to sleep" and then sees an
+        // empty queue cannot miss a producer that pushed and then checked for sleepers.
+        bool empty() const {
+            return tail_->next.load() == nullptr;
+        }
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{nullptr};
+            T value;
+        };
+
+        Node stub_;
+        std::atomic<Node*> head_;
+        Node* tail_;
+    };
+}
@@ -1,94 +1,200 @@
 #include "autograd/ops.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/grad_store.hpp"
+#include "autograd/parallel.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace autograd {
+    namespace {
+        // A leaf nobody differentiates: interned constants, inputs created with
+        // requires_grad=false and anything computed under NoGradGuard.
+        bool is_constant(const std::shared_ptr<Value>& v) {
+            return !v->requires_grad && v->parents.empty();
+        }
+
+        // Nothing is recorded when grad mode is off or every input is a constant; the result
+        // is then folded into a constant leaf on the spot.
+        bool should_record(const std::shared_ptr<Value>& x, const std::shared_ptr<Value>& y = nullptr) {
+            return is_grad_enabled() && !(is_constant(x) && (y == nullptr || is_constant(y)));
+        }
+    }
+
     std::shared_ptr<Value> add(std::shared_ptr<Value> x, std::shared_ptr<Value> y) {
         auto out = std::make_shared<Value>();
+        out->value = x->value + y->value;
+        if (!should_record(x, y)) {
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Add;
         out->parents.push_back(x);
         out->parents.push_back(y);
-        out->value = x->value + y->value;
 
-        out->grad_fn = [x, y, out]() {
-            x->grad += out->grad;
-            y->grad += out->grad;
+        // out owns its grad_fn, so the closure refers to it by raw pointer rather than keeping
+        // it alive (a shared_ptr here would be a cycle and the graph would never be freed).
+        out->grad_fn = [x, y, raw = out.get()]() {
+            if (x->requires_grad) {
+                grad_ref(x.get()) += grad_ref(raw);
+            }
+            if (y->requires_grad) {
+                grad_ref(y.get()) += grad_ref(raw);
+            }
+        };
+        out->vjp_fn = [](std::shared_ptr<Value> g) {
+            return std::vector<std::shared_ptr<Value>>{g, g};
         };
         return out;
     }
 
     std::shared_ptr<Value> mult(std::shared_ptr<Value> x, std::shared_ptr<Value> y) {
         auto out = std::make_shared<Value>();
+        out->value = x->value * y->value;
+        if (!should_record(x, y)) {
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Mult;
         out->parents.push_back(x);
         out->parents.push_back(y);
-        out->value = x->value * y->value;
 
-        out->grad_fn = [x, y, out]() {
-            x->grad += out->grad * y->value;
-            y->grad += out->grad * x->value;
+        out->grad_fn = [x, y, raw = out.get()]() {
+            if (x->requires_grad) {
+                grad_ref(x.get()) += grad_ref(raw) * y->value;
+            }
+            if (y->requires_grad) {
+                grad_ref(y.get()) += grad_ref(raw) * x->value;
+            }
+        };
+        out->vjp_fn = [x, y](std::shared_ptr<Value> g) {
+            return std::vector<std::shared_ptr<Value>>{mult(g, y), mult(g, x)};
         };
         return out;
     }
      std::shared_ptr<Value> sub( std::shared_ptr<Value> x, std::shared_ptr<Value> y) {
         auto out = std::make_shared<Value>();
+        out->value = x->value - y->value;
+        if (!should_record(x, y)) {
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Sub;
         out->parents.push_back(x);
         out->parents.push_back(y);
-        out->value = x->value - y->value;
 
-        out->grad_fn = [x, y, out]() {
-            x->grad += out->grad;
-            y->grad -= out->grad;
+        out->grad_fn = [x, y, raw = out.get()]() {
+            if (x->requires_grad) {
+                grad_ref(x.get()) += grad_ref(raw);
+            }
+            if (y->requires_grad) {
+                grad_ref(y.get()) -= grad_ref(raw);
+            }
+        };
+        out->vjp_fn = [](std::shared_ptr<Value> g) {
+            return std::vector<std::shared_ptr<Value>>{g, mult(g, interned_constant(-1.0))};
         };
         return out;
      }
      std::shared_ptr<Value> div( std::shared_ptr<Value> x, std::shared_ptr<Value> y) {
         auto out = std::make_shared<Value>();
+        out->value = x->value / y->value;
+        if (!should_record(x, y)) {
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Div;
         out->parents.push_back(x);
         out->parents.push_back(y);
-        out->value = x->value / y->value;
 
-        out->grad_fn = [x, y, out]() {
-            x->grad += out->grad / y->value;
-            y->grad -= out->grad * x->value / (y->value * y->value);
+        out->grad_fn = [x, y, raw = out.get()]() {
+            if (x->requires_grad) {
+                grad_ref(x.get()) += grad_ref(raw) / y->value;
+            }
+            if (y->requires_grad) {
+                grad_ref(y.get()) -= grad_ref(raw) * x->value / (y->value * y->value);
+            }
+        };
+        out->vjp_fn = [x, y](std::shared_ptr<Value> g) {
+            auto dy = div(mult(g, x), mult(y, y));
+            return std::vector<std::shared_ptr<Value>>{div(g, y), mult(dy, interned_constant(-1.0))};
         };
         return out;
      }
 
      std::shared_ptr<Value> exp( std::shared_ptr<Value> x) {
         auto out = std::make_shared<Value>();
-        out->parents.push_back(x);
         out->value = std::exp(x->value);
+        if (!should_record(x)) {
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Exp;
+        out->parents.push_back(x);
 
-        out->grad_fn = [x, out]() {
-            x->grad += out->grad * out->value;
+        out->grad_fn = [x, raw = out.get()]() {
+            if (x->requires_grad) {
+                grad_ref(x.get()) += grad_ref(raw) * raw->value;
+            }
+        };
+        // Recompute exp(x) instead of capturing out, which would make out own itself.
+        out->vjp_fn = [x](std::shared_ptr<Value> g) {
+            return std::vector<std::shared_ptr<Value>>{mult(g, exp(x))};
         };
         return out;
      }
     std::shared_ptr<Value> log( std::shared_ptr<Value> x) {
         auto out = std::make_shared<Value>();
-        out->parents.push_back(x);
         out->value = std::log(x->value);
+        if (!should_record(x)) {
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Log;
+        out->parents.push_back(x);
 
-        out->grad_fn = [x, out]() {
-            x->grad += out->grad / x->value;
+        out->grad_fn = [x, raw = out.get()]() {
+            if (x->requires_grad) {
+                grad_ref(x.get()) += grad_ref(raw) / x->value;
+            }
+        };
+        out->vjp_fn = [x](std::shared_ptr<Value> g) {
+            return std::vector<std::shared_ptr<Value>>{div(g, x)};
         };
         return out;
     }
 
     std::shared_ptr<Value> max(std::shared_ptr<Value> a, std::shared_ptr<Value> b) {
         auto out = std::make_shared<Value>();
+        if (!should_record(a, b)) {
+            out->value = std::max(a->value, b->value);
+            out->requires_grad = false;
+            return out;
+        }
+        out->op = Op::Max;
         out->parents.push_back(a);
         out->parents.push_back(b);
 
         if (a->value >= b->value) {
             out->value = a->value;
-            out->grad_fn = [a,b, out]() {
-                a->grad += out->grad;
-                b->grad += 0.0;
+            out->grad_fn = [a, raw = out.get()]() {
+                if (a->requires_grad) {
+                    grad_ref(a.get()) += grad_ref(raw);
+                }
+            };
+            out->vjp_fn = [](std::shared_ptr<Value> g) {
+                return std::vector<std::shared_ptr<Value>>{g, nullptr};
             };
         } 
         else {
             out->value = b->value;
-            out->grad_fn = [a, b, out]() {
-                b->grad += out->grad;
-                a->grad += 0.0;
+            out->grad_fn = [b, raw = out.get()]() {
+                if (b->requires_grad) {
+                    grad_ref(b.get()) += grad_ref(raw);
+                }
+            };
+            out->vjp_fn = [](std::shared_ptr<Value> g) {
+                return std::vector<std::shared_ptr<Value>>{nullptr, g};
             };
 
         }
@@ -114,33 +220,179 @@ namespace autograd {
         
     }
 
+    namespace {
+        // Shared between a matmul's hub node and its outputs.
+        struct MatmulState {
+            int rows, inner, cols;
+            std::vector<std::shared_ptr<Value>> output_grads;   // grad_graph: upstream gradient per output
+        };
+    }
+
     std::shared_ptr<Tensor> matmul(std::shared_ptr<Tensor> a, std::shared_ptr<Tensor> b) {
         // check dimensions 
         if (a->shape[1] != b->shape[0])     {
             throw std::invalid_argument("Incompatible tensor shapes for matrix multiplication");
         }
         // index for a flat vector index = i * col + j
+        int rows = a->shape[0];
+        int inner = a->shape[1];
+        int cols = b->shape[1];
         auto out = std::make_shared<Tensor>();
-        out->shape = {a->shape[0], b->shape[1]};
-        auto out_values = std::vector<std::shared_ptr<Value>>();
-        auto inner = a->shape[1];
-       
-        for (int i = 0; i < a->shape[0]; ++i) {
-            for (int j = 0; j < b->shape[1]; ++j) {
-                std::vector<std::shared_ptr<Value>> a_row;
-                std::vector<std::shared_ptr<Value>> b_col;
+        out->shape = {rows, cols};
+        out->values = std::vector<std::shared_ptr<Value>>((size_t)rows * cols);
+
+        // The whole product is one tensor-level op: outputs hang off a single hub node whose
+        // parents are a's and b's values, and whose backward computes dA and dB as GEMMs.
+        // Like should_record: with grad mode off or only constant operands, the outputs are
+        // plain constants and no hub or state is allocated.
+        bool record = is_grad_enabled() &&
+            !(std::all_of(a->values.begin(), a->values.end(), is_constant) && std::all_of(b->values.begin(), b->values.end(), is_constant));
+        std::shared_ptr<Value> hub = nullptr;
+        std::shared_ptr<MatmulState> state = nullptr;
+        if (record) {
+            hub = std::make_shared<Value>();
+            hub->parents.reserve(a->values.size() + b->values.size());
+            hub->parents.insert(hub->parents.end(), a->values.begin(), a->values.end());
+            hub->parents.insert(hub->parents.end(), b->values.begin(), b->values.end());
+            state = std::make_shared<MatmulState>();
+            state->rows = rows;
+            state->inner = inner;
+            state->cols = cols;
+        }
+
+        parallel_for(0, rows, rows_per_chunk((int64_t)inner * cols), [&](int64_t first, int64_t last) {
+            auto row = std::vector<double>(cols);
+            for (int64_t i = first; i < last; ++i) {
+                std::fill(row.begin(), row.end(), 0.0);
                 for (int k = 0; k < inner; ++k) {
-                    a_row.push_back(a->values[i * a->shape[1] + k]);
-                    b_col.push_back(b->values[k * b->shape[1] + j]);
+                    double a_ik = a->values[i * inner + k]->value;
+                    for (int j = 0; j < cols; ++j) {
+                        row[j] += a_ik * b->values[(size_t)k * cols + j]->value;
+                    }
+                }
+                for (int j = 0; j < cols; ++j) {
+                    auto node = std::make_shared<Value>();
+                    node->value = row[j];
+                    if (!record) {
+                        node->requires_grad = false;
+                    } else {
+                        size_t idx = i * cols + j;
+                        node->parents.push_back(hub);
+                        // Hand the upstream gradient to the hub for this pass only; a gradient
+                        // left on an output by an earlier pass never reaches it.
+                        node->grad_fn = [raw = node.get(), hub = hub.get(), idx, size = (size_t)rows * cols]() {
+                            hub_grads(hub, size)[idx] += grad_ref(raw);
+                        };
+                        // Same for hub->vjp_fn, which consumes output_grads.
+                        node->vjp_fn = [state, idx](std::shared_ptr<Value> g) {
+                            state->output_grads[idx] = g;
+                            return std::vector<std::shared_ptr<Value>>{g};
+                        };
+                    }
+                    out->values[i * cols + j] = node;
                 }
-                 auto dot_product = dot( std::make_shared<Tensor>(Tensor{a_row, {1, (int)a_row.size()}}), 
-                            std::make_shared<Tensor>(Tensor{b_col, {(int)b_col.size(), 1}}) );
-                out_values.push_back(dot_product);   
             }
-           
+        });
+        if (!record) {
+            return out;
         }
-         
-        out->values = out_values;
+        state->output_grads.resize((size_t)rows * cols);
+
+        auto raw = hub.get();
+        hub->grad_fn = [raw, state]() {
+            int rows = state->rows, inner = state->inner, cols = state->cols;
+            auto& parents = raw->parents;
+            size_t b_offset = (size_t)rows * inner;
+            auto dC = take_hub_grads(raw, (size_t)rows * cols);
+            // A pass that seeds few outputs (a jacobian row) leaves most of dC zero, so the
+            // GEMMs below only visit the rows and columns of dC that hold a non-zero entry.
+            auto live_rows = std::vector<int>();
+            auto live_cols = std::vector<int>();
+            auto col_live = std::vector<char>(cols, 0);
+            for (int i = 0; i < rows; ++i) {
+                bool row_live = false;
+                for (int j = 0; j < cols; ++j) {
+                    if (dC[(size_t)i * cols + j] != 0.0) {
+                        row_live = true;
+                        col_live[j] = 1;
+                    }
+                }
+                if (row_live) {
+                    live_rows.push_back(i);
+                }
+            }
+            if (live_rows.empty()) {
+                return;
+            }
+            for (int j = 0; j < cols; ++j) {
+                if (col_live[j]) {
+                    live_cols.push_back(j);
+                }
+            }
+            int64_t num_rows = (int64_t)live_rows.size(), num_cols = (int64_t)live_cols.size();
+
+            // dA = dC B^T and dB = A^T dC go to dense buffers first: the same Value may appear
+            // several times in a or b, so accumulation into the nodes stays serial.
+            auto dA = std::vector<double>((size_t)rows * inner, 0.0);
+            parallel_for(0, num_rows, rows_per_chunk((int64_t)inner * num_cols), [&](int64_t first, int64_t last) {
+                for (int64_t r = first; r < last; ++r) {
+                    size_t i = live_rows[r];
+                    for (int k = 0; k < inner; ++k) {
+                        double sum = 0.0;
+                        for (int j : live_cols) {
+                            sum += dC[i * cols + j] * parents[b_offset + (size_t)k * cols + j]->value;
+                        }
+                        dA[i * inner + k] = sum;
+                    }
+                }
+            });
+            auto dB = std::vector<double>((size_t)inner * cols, 0.0);
+            parallel_for(0, inner, rows_per_chunk(num_rows * num_cols), [&](int64_t first, int64_t last) {
+                for (int64_t k = first; k < last; ++k) {
+                    for (int i : live_rows) {
+                        double a_ik = parents[(size_t)i * inner + k]->value;
+                        for (int j : live_cols) {
+                            dB[k * cols + j] += a_ik * dC[(size_t)i * cols + j];
+                        }
+                    }
+                }
+            });
+            for (size_t n = 0; n < dA.size(); ++n) {
+                if (dA[n] != 0.0 && parents[n]->requires_grad) {
+                    grad_ref(parents[n].get()) += dA[n];
+                }
+            }
+            for (size_t n = 0; n < dB.size(); ++n) {
+                if (dB[n] != 0.0 && parents[b_offset + n]->requires_grad) {
+                    grad_ref(parents[b_offset + n].get()) += dB[n];
+                }
+            }
+        };
+        hub->vjp_fn = [raw, state](std::shared_ptr<Value>) {
+            int rows = state->rows, inner = state->inner, cols = state->cols;
+            auto& parents = raw->parents;
+            size_t b_offset = (size_t)rows * inner;
+            auto& dC = state->output_grads;
+            auto grads = std::vector<std::shared_ptr<Value>>(parents.size());
+            auto accumulate = [](std::shared_ptr<Value>& slot, std::shared_ptr<Value> g) {
+                slot = slot ? add(slot, g) : g;
+            };
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    auto& g = dC[(size_t)i * cols + j];
+                    if (g == nullptr) {
+                        continue;
+                    }
+                    for (int k = 0; k < inner; ++k) {
+                        accumulate(grads[(size_t)i * inner + k], mult(g, parents[b_offset + (size_t)k * cols + j]));
+                        accumulate(grads[b_offset + (size_t)k * cols + j], mult(g, parents[(size_t)i * inner + k]));
+                    }
+                }
+            }
+            // Consumed: a later pass must not see this pass's gradients.
+            std::fill(dC.begin(), dC.end(), nullptr);
+            return grads;
+        };
         return out;
     }
 
@@ -153,13 +405,15 @@ namespace autograd {
             }
             auto out = std::make_shared<Tensor>();
             out->shape = X->shape;
-            std::vector<std::shared_ptr<Value>> out_values;
-            for (int i = 0 ; i < X->shape[0]; ++i) {
-                for (int j = 0; j < X->shape[1]; ++j) {
-                    auto sum = add(X->values[i * X->shape[1] + j], b->values[i]);
-                    out_values.push_back(sum);
+            std::vector<std::shared_ptr<Value>> out_values(X->values.size());
+            int cols = X->shape[1];
+            parallel_for(0, X->shape[0], std::max(1, 4096 / std::max(1, cols)), [&](int64_t first, int64_t last) {
+                for (int64_t i = first; i < last; ++i) {
+                    for (int j = 0; j < cols; ++j) {
+                        out_values[i * cols + j] = add(X->values[i * cols + j], b->values[i]);
+                    }
                 }
-            }
+            });
             out->values = out_values;
             return out;
 
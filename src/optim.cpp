@@ -0,0 +1,29 @@
+#include "autograd/optim.hpp"
+
+namespace autograd {
+    void zero_grad(std::shared_ptr<Tensor> param) {
+        for (auto& val : param->values) {
+            val->grad = 0.0;
+        }
+    }
+
+    void sgd_step(std::shared_ptr<Tensor> param, double learning_rate) {
+        for (auto& val : param->values) {
+            val->value -= learning_rate * val->grad;
+            val->grad = 0.0;
+        }
+    }
+
+    void sgd_step(std::shared_ptr<Embedding> table, double learning_rate) {
+        auto grad = sparse_grad(table);
+        auto& values = table->weight->values;
+        for (size_t n = 0; n < grad.rows.size(); ++n) {
+            for (int j = 0; j < grad.dim; ++j) {
+                auto& val = values[grad.rows[n] * grad.dim + j];
+                val->value -= learning_rate * grad.values[n * grad.dim + j];
+                val->grad = 0.0;
+            }
+        }
+        table->touched_rows.clear();
+    }
+}
@@ -0,0 +1,192 @@
+#include "autograd/parallel.hpp"
+#include "autograd/grad_mode.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace autograd {
+    namespace {
+        thread_local bool in_parallel_region = false;
+    }
+
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int num_threads) : size_(num_threads) {
+            for (int i = 1; i < num_threads; ++i) {
+                workers_.emplace_back([this]() { work(); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            ready_.notify_all();
+            for (auto& w : workers_) {
+                w.join();
+            }
+        }
+
+        int size() const {
+            return size_;
+        }
+
+        void post(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            ready_.notify_one();
+        }
+
+    private:
+        void work() {
+            in_parallel_region = true;
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                    if (tasks_.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                task();
+            }
+        }
+
+        int size_;
+        std::vector<std::thread> workers_;
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        bool stopping_ = false;
+    };
+
+    namespace {
+        // Set by NumThreadsGuard; replaces the shared pool for this thread only.
+        thread_local std::shared_ptr<ThreadPool> scoped_pool;
+
+        // Bookkeeping for one parallel_for call. Helpers claim chunks until none are left, so
+        // a helper that starts late simply finds nothing to do.
+        struct Region {
+            std::atomic<int64_t> next_chunk{0};
+            int64_t num_chunks = 0;
+            std::atomic<int64_t> done{0};
+            std::mutex mutex;
+            std::condition_variable finished;
+            std::exception_ptr error;
+        };
+
+        int default_num_threads() {
+            if (const char* env = std::getenv("AUTOGRAD_NUM_THREADS")) {
+                int n = std::atoi(env);
+                if (n > 0) {
+                    return n;
+                }
+            }
+            return (int)std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        std::mutex pool_mutex;
+        std::shared_ptr<ThreadPool> pool;
+
+        std::shared_ptr<ThreadPool> get_pool() {
+            if (scoped_pool) {
+                return scoped_pool;
+            }
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (!pool) {
+                pool = std::make_shared<ThreadPool>(default_num_threads());
+            }
+            return pool;
+        }
+    }
+
+    void set_num_threads(int num_threads) {
+        auto replacement = std::make_shared<ThreadPool>(num_threads > 0 ? num_threads : default_num_threads());
+        std::shared_ptr<ThreadPool> old;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            old = pool;
+            pool = replacement;
+        }
+        // The old pool joins its workers once the last parallel_for still using it returns.
+    }
+
+    int get_num_threads() {
+        return get_pool()->size();
+    }
+
+    NumThreadsGuard::NumThreadsGuard(int num_threads) : previous(scoped_pool) {
+        if (num_threads > 0 && num_threads != get_pool()->size()) {
+            scoped_pool = std::make_shared<ThreadPool>(num_threads);
+        }
+    }
+
+    NumThreadsGuard::~NumThreadsGuard() {
+        scoped_pool = previous;
+    }
+
+    void parallel_for(int64_t begin, int64_t end, int64_t grain_size, const std::function<void(int64_t, int64_t)>& fn) {
+        if (end <= begin) {
+            return;
+        }
+        int64_t size = end - begin;
+        grain_size = std::max<int64_t>(grain_size, 1);
+        auto threads = in_parallel_region ? std::shared_ptr<ThreadPool>() : get_pool();
+        if (!threads || threads->size() == 1 || size <= grain_size) {
+            fn(begin, end);
+            return;
+        }
+
+        int64_t chunk = std::max(grain_size, (size + threads->size() - 1) / threads->size());
+        auto region = std::make_shared<Region>();
+        region->num_chunks = (size + chunk - 1) / chunk;
+        bool grad_mode = is_grad_enabled();
+
+        auto run_chunks = [region, begin, end, chunk, grad_mode, &fn]() {
+            bool previous = is_grad_enabled();
+            set_grad_enabled(grad_mode);
+            for (int64_t c = region->next_chunk++; c < region->num_chunks; c = region->next_chunk++) {
+                try {
+                    fn(begin + c * chunk, std::min(end, begin + (c + 1) * chunk));
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(region->mutex);
+                    if (!region->error) {
+                        region->error = std::current_exception();
+                    }
+                }
+                if (++region->done == region->num_chunks) {
+                    std::lock_guard<std::mutex> lock(region->mutex);
+                    region->finished.notify_all();
+                }
+            }
+            set_grad_enabled(previous);
+        };
+
+        // fn is captured by reference: helpers only touch it while claiming chunks, and the
+        // caller does not return before every chunk is done.
+        int helpers = (int)std::min<int64_t>(threads->size() - 1, region->num_chunks - 1);
+        for (int h = 0; h < helpers; ++h) {
+            threads->post(run_chunks);
+        }
+        in_parallel_region = true;
+        run_chunks();
+        in_parallel_region = false;
+
+        std::unique_lock<std::mutex> lock(region->mutex);
+        region->finished.wait(lock, [&] { return region->done == region->num_chunks; });
+        if (region->error) {
+            std::rethrow_exception(region->error);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#include "autograd/per_sample.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/parallel.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace autograd {
+    std::vector<PerSampleLinearGrads> per_sample_linear_grads(const std::vector<std::shared_ptr<Value>>& losses, const std::vector<LinearActivations>& layers) {
+        int batch = (int)losses.size();
+        auto ys = std::vector<std::shared_ptr<Value>>();
+        for (auto& layer : layers) {
+            if (layer.X->shape[1] != batch || layer.Y->shape[1] != batch) {
+                throw std::invalid_argument("per_sample_linear_grads: X and Y need one column per loss");
+            }
+            ys.insert(ys.end(), layer.Y->values.begin(), layer.Y->values.end());
+        }
+        auto dY = grad(losses, ys);
+
+        auto out = std::vector<PerSampleLinearGrads>();
+        size_t offset = 0;
+        for (auto& layer : layers) {
+            PerSampleLinearGrads g;
+            g.batch = batch;
+            g.out_features = layer.Y->shape[0];
+            g.in_features = layer.X->shape[0];
+            g.weight = std::vector<double>((size_t)batch * g.out_features * g.in_features);
+            g.bias = std::vector<double>((size_t)batch * g.out_features);
+            const double* dy = dY.data() + offset;
+            int out_features = g.out_features, in_features = g.in_features;
+            int64_t grain = std::max<int64_t>(1, 4096 / std::max<int64_t>(1, (int64_t)out_features * in_features));
+            parallel_for(0, batch, grain, [&](int64_t first, int64_t last) {
+                auto x = std::vector<double>(in_features);
+                for (int64_t j = first; j < last; ++j) {
+                    for (int k = 0; k < in_features; ++k) {
+                        x[k] = layer.X->values[(size_t)k * batch + j]->value;
+                    }
+                    for (int o = 0; o < out_features; ++o) {
+                        double d = dy[(size_t)o * batch + j];
+                        g.bias[j * out_features + o] = d;
+                        double* w = g.weight.data() + ((size_t)j * out_features + o) * in_features;
+                        for (int k = 0; k < in_features; ++k) {
+                            w[k] = d * x[k];
+                        }
+                    }
+                }
+            });
+            offset += layer.Y->values.size();
+            out.push_back(std::move(g));
+        }
+        return out;
+    }
+}
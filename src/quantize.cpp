@@ -0,0 +1,258 @@
+#include "autograd/quantize.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define AUTOGRAD_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace autograd {
+    namespace {
+        int pad32(int n) {
+            return (n + 31) / 32 * 32;
+        }
+
+        int8_t saturate_int8(double v) {
+            return (int8_t)std::max(-127.0, std::min(127.0, std::nearbyint(v)));
+        }
+
+        // One output row: c[n] = sum_k a[k] * W[n][k].
+        using RowKernel = void (*)(const int8_t* a, const int8_t* W, const int32_t* w_row_sums, int32_t* c, int N, int K);
+
+        void row_scalar(const int8_t* a, const int8_t* W, const int32_t*, int32_t* c, int N, int K) {
+            for (int n = 0; n < N; ++n) {
+                const int8_t* w = W + (size_t)n * K;
+                int32_t acc = 0;
+                for (int k = 0; k < K; ++k) {
+                    acc += (int32_t)a[k] * (int32_t)w[k];
+                }
+                c[n] = acc;
+            }
+        }
+
+#ifdef AUTOGRAD_X86_KERNELS
+        __attribute__((target("avx2")))
+        int32_t hsum_epi32(__m256i v) {
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtsi128_si32(s);
+        }
+
+        // Sign-extend to int16 and use madd: 16 products per instruction, pairwise summed to int32.
+        __attribute__((target("avx2")))
+        void row_avx2(const int8_t* a, const int8_t* W, const int32_t*, int32_t* c, int N, int K) {
+            for (int n = 0; n < N; ++n) {
+                const int8_t* w = W + (size_t)n * K;
+                __m256i acc = _mm256_setzero_si256();
+                for (int k = 0; k < K; k += 32) {
+                    __m256i va = _mm256_loadu_si256((const __m256i*)(a + k));
+                    __m256i vw = _mm256_loadu_si256((const __m256i*)(w + k));
+                    __m256i a_lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(va));
+                    __m256i a_hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(va, 1));
+                    __m256i w_lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(vw));
+                    __m256i w_hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(vw, 1));
+                    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a_lo, w_lo));
+                    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a_hi, w_hi));
+                }
+                c[n] = hsum_epi32(acc);
+            }
+        }
+
+        // vpdpbusd multiplies unsigned by signed bytes, so activations are shifted by +128
+        // (xor 0x80) and 128 * sum_k W[n][k] is subtracted at the end.
+        __attribute__((target("avx2,avx512f,avx512vl,avx512bw,avx512vnni")))
+        void row_vnni(const int8_t* a, const int8_t* W, const int32_t* w_row_sums, int32_t* c, int N, int K) {
+            const __m256i flip = _mm256_set1_epi8((char)0x80);
+            for (int n = 0; n < N; ++n) {
+                const int8_t* w = W + (size_t)n * K;
+                __m256i acc = _mm256_setzero_si256();
+                for (int k = 0; k < K; k += 32) {
+                    __m256i va = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + k)), flip);
+                    __m256i vw = _mm256_loadu_si256((const __m256i*)(w + k));
+                    acc = _mm256_dpbusd_epi32(acc, va, vw);
+                }
+                c[n] = hsum_epi32(acc) - 128 * w_row_sums[n];
+            }
+        }
+#endif
+
+        RowKernel row_kernel(Int8Kernel kernel) {
+#ifdef AUTOGRAD_X86_KERNELS
+            if (kernel == Int8Kernel::VNNI) {
+                return row_vnni;
+            }
+            if (kernel == Int8Kernel::AVX2) {
+                return row_avx2;
+            }
+#endif
+            if (kernel != Int8Kernel::Scalar) {
+                throw std::invalid_argument("int8 kernel not available on this platform");
+            }
+            return row_scalar;
+        }
+
+        // Runs the GEMM one activation row at a time and hands each freshly computed int32 row
+        // to the output stage while it is still in cache.
+        template <class Stage>
+        void run_layer(const QuantizedLinear& layer, const int8_t* x_q, int batch, Stage stage) {
+            static const RowKernel kernel = row_kernel(detect_int8_kernel());
+            auto acc = std::vector<int32_t>(layer.out_features);
+            for (int m = 0; m < batch; ++m) {
+                kernel(x_q + (size_t)m * layer.padded_in, layer.weight.data(), layer.weight_row_sum.data(), acc.data(), layer.out_features, layer.padded_in);
+                for (int o = 0; o < layer.out_features; ++o) {
+                    double y = acc[o] * ((double)layer.input_scale * layer.weight_scale[o]) + layer.bias[o];
+                    if (layer.relu && y < 0.0) {
+                        y = 0.0;
+                    }
+                    stage(m, o, y);
+                }
+            }
+        }
+    }
+
+    Int8Kernel detect_int8_kernel() {
+#ifdef AUTOGRAD_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw")) {
+            return Int8Kernel::VNNI;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Int8Kernel::AVX2;
+        }
+#endif
+        return Int8Kernel::Scalar;
+    }
+
+    const char* int8_kernel_name(Int8Kernel kernel) {
+        switch (kernel) {
+            case Int8Kernel::VNNI: return "vnni";
+            case Int8Kernel::AVX2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    void int8_gemm(const int8_t* A, const int8_t* W, const int32_t* w_row_sums, int32_t* C, int M, int N, int K, Int8Kernel kernel) {
+        if (K % 32 != 0) {
+            throw std::invalid_argument("int8_gemm: K must be a multiple of 32");
+        }
+        auto row = row_kernel(kernel);
+        for (int m = 0; m < M; ++m) {
+            row(A + (size_t)m * K, W, w_row_sums, C + (size_t)m * N, N, K);
+        }
+    }
+
+    QuantizedLinear quantize_linear(std::shared_ptr<Tensor> weight, std::shared_ptr<Tensor> bias, const std::vector<std::shared_ptr<Tensor>>& calibration_inputs, bool relu) {
+        int out_features = weight->shape[0];
+        int in_features = weight->shape[1];
+        if (bias->shape[0] != out_features) {
+            throw std::invalid_argument("Incompatible tensor shapes for quantize_linear");
+        }
+        QuantizedLinear layer;
+        layer.in_features = in_features;
+        layer.out_features = out_features;
+        layer.padded_in = pad32(in_features);
+        layer.relu = relu;
+        layer.weight = std::vector<int8_t>((size_t)out_features * layer.padded_in, 0);
+
+        for (int o = 0; o < out_features; ++o) {
+            double max_abs = 0.0;
+            for (int k = 0; k < in_features; ++k) {
+                max_abs = std::max(max_abs, std::abs(weight->values[o * in_features + k]->value));
+            }
+            double scale = max_abs > 0.0 ? max_abs / 127.0 : 1.0;
+            int32_t row_sum = 0;
+            for (int k = 0; k < in_features; ++k) {
+                auto q = saturate_int8(weight->values[o * in_features + k]->value / scale);
+                layer.weight[(size_t)o * layer.padded_in + k] = q;
+                row_sum += q;
+            }
+            layer.weight_scale.push_back((float)scale);
+            layer.weight_row_sum.push_back(row_sum);
+            layer.bias.push_back((float)bias->values[o]->value);
+        }
+
+        double max_abs = 0.0;
+        for (auto& X : calibration_inputs) {
+            if (X->shape[0] != in_features) {
+                throw std::invalid_argument("Calibration input does not match the layer's input size");
+            }
+            for (auto& v : X->values) {
+                max_abs = std::max(max_abs, std::abs(v->value));
+            }
+        }
+        layer.input_scale = max_abs > 0.0 ? (float)(max_abs / 127.0) : 1.0f;
+        return layer;
+    }
+
+    std::vector<int8_t> quantize_input(const QuantizedLinear& layer, const std::vector<float>& x, int batch) {
+        if ((int)x.size() != batch * layer.in_features) {
+            throw std::invalid_argument("quantize_input: expected batch * in_features values");
+        }
+        auto x_q = std::vector<int8_t>((size_t)batch * layer.padded_in, 0);
+        double inv_scale = 1.0 / layer.input_scale;
+        for (int m = 0; m < batch; ++m) {
+            for (int k = 0; k < layer.in_features; ++k) {
+                x_q[(size_t)m * layer.padded_in + k] = saturate_int8(x[(size_t)m * layer.in_features + k] * inv_scale);
+            }
+        }
+        return x_q;
+    }
+
+    std::vector<float> quantized_forward(const QuantizedLinear& layer, const std::vector<float>& x, int batch) {
+        return quantized_forward(layer, quantize_input(layer, x, batch), batch);
+    }
+
+    std::vector<float> quantized_forward(const QuantizedLinear& layer, const std::vector<int8_t>& x_q, int batch) {
+        if ((int)x_q.size() != batch * layer.padded_in) {
+            throw std::invalid_argument("quantized_forward: expected batch * padded_in values");
+        }
+        auto y = std::vector<float>((size_t)batch * layer.out_features);
+        run_layer(layer, x_q.data(), batch, [&](int m, int o, double v) {
+            y[(size_t)m * layer.out_features + o] = (float)v;
+        });
+        return y;
+    }
+
+    std::vector<int8_t> quantized_forward_int8(const QuantizedLinear& layer, const std::vector<int8_t>& x_q, int batch, float output_scale) {
+        if ((int)x_q.size() != batch * layer.padded_in) {
+            throw std::invalid_argument("quantized_forward_int8: expected batch * padded_in values");
+        }
+        int next_padded = pad32(layer.out_features);
+        auto y = std::vector<int8_t>((size_t)batch * next_padded, 0);
+        double inv_scale = 1.0 / output_scale;
+        run_layer(layer, x_q.data(), batch, [&](int m, int o, double v) {
+            y[(size_t)m * next_padded + o] = saturate_int8(v * inv_scale);
+        });
+        return y;
+    }
+
+    std::shared_ptr<Tensor> quantized_forward(const QuantizedLinear& layer, std::shared_ptr<Tensor> X) {
+        if (X->shape[0] != layer.in_features) {
+            throw std::invalid_argument("Incompatible tensor shapes for quantized_forward");
+        }
+        int batch = X->shape[1];
+        auto x = std::vector<float>((size_t)batch * layer.in_features);
+        for (int k = 0; k < layer.in_features; ++k) {
+            for (int m = 0; m < batch; ++m) {
+                x[(size_t)m * layer.in_features + k] = (float)X->values[k * batch + m]->value;
+            }
+        }
+        auto y = quantized_forward(layer, x, batch);
+
+        auto out = std::make_shared<Tensor>();
+        out->shape = {layer.out_features, batch};
+        out->values.reserve(y.size());
+        for (int o = 0; o < layer.out_features; ++o) {
+            for (int m = 0; m < batch; ++m) {
+                auto val = std::make_shared<Value>();
+                val->value = y[(size_t)m * layer.out_features + o];
+                val->requires_grad = false;
+                out->values.push_back(val);
+            }
+        }
+        return out;
+    }
+}
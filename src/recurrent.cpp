@@ -0,0 +1,513 @@
+#include "autograd/recurrent.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/grad_store.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace autograd {
+    namespace {
+        double sigmoid(double v) {
+            return 1.0 / (1.0 + std::exp(-v));
+        }
+
+        // Columns [begin, end) of [x; h] that feed a gate row; everything else in the row is a
+        // structural zero (the GRU's block layout).
+        struct Span {
+            int begin, end;
+        };
+
+        // Saved by a recorded step for its hand-written backward.
+        struct StepState {
+            int in, hidden, batch;
+            std::vector<Span> spans;                     // per gate row
+            std::vector<double> xh;                      // [x; h], (in + H, batch)
+            std::vector<double> gates;                   // gate activations, (4H, batch); RNN: h', (H, batch)
+            std::vector<double> aux;                     // LSTM: c_prev then tanh(c'); GRU: W_hn h + b_hn
+        };
+
+        std::vector<double> read_values(const std::vector<std::shared_ptr<Value>>& values, size_t begin, size_t count) {
+            auto out = std::vector<double>(count);
+            for (size_t n = 0; n < count; ++n) {
+                out[n] = values[begin + n]->value;
+            }
+            return out;
+        }
+
+        void check_shape(const std::shared_ptr<Tensor>& t, int rows, int cols, const char* what) {
+            if (t->shape[0] != rows || t->shape[1] != cols) {
+                throw std::invalid_argument(std::string("Incompatible tensor shapes for recurrent step: ") + what);
+            }
+        }
+
+        // z = W xh + b for every gate row at once, (rows, batch).
+        std::vector<double> gate_gemm(const std::vector<double>& W, const std::vector<double>& b, const StepState& s) {
+            int rows = (int)s.spans.size();
+            int cols = s.in + s.hidden;
+            int batch = s.batch;
+            auto z = std::vector<double>((size_t)rows * batch);
+            parallel_for(0, rows, rows_per_chunk((int64_t)cols * batch), [&](int64_t first, int64_t last) {
+                for (int64_t r = first; r < last; ++r) {
+                    double* zr = z.data() + r * batch;
+                    std::fill(zr, zr + batch, b[r]);
+                    for (int k = s.spans[r].begin; k < s.spans[r].end; ++k) {
+                        double w = W[r * cols + k];
+                        const double* xk = s.xh.data() + (size_t)k * batch;
+                        for (int j = 0; j < batch; ++j) {
+                            zr[j] += w * xk[j];
+                        }
+                    }
+                }
+            });
+            return z;
+        }
+
+        // From dz (rows, batch): dW = dz xh^T and db = dz 1 over each row's span, and dxh = W^T dz.
+        void gate_gemm_backward(const std::vector<double>& W, const std::vector<double>& dz, const StepState& s, std::vector<double>& dW, std::vector<double>& db, std::vector<double>& dxh) {
+            int rows = (int)s.spans.size();
+            int cols = s.in + s.hidden;
+            int batch = s.batch;
+            dW.assign((size_t)rows * cols, 0.0);
+            db.assign(rows, 0.0);
+            dxh.assign((size_t)cols * batch, 0.0);
+            parallel_for(0, rows, rows_per_chunk((int64_t)cols * batch), [&](int64_t first, int64_t last) {
+                for (int64_t r = first; r < last; ++r) {
+                    const double* dzr = dz.data() + r * batch;
+                    for (int j = 0; j < batch; ++j) {
+                        db[r] += dzr[j];
+                    }
+                    for (int k = s.spans[r].begin; k < s.spans[r].end; ++k) {
+                        const double* xk = s.xh.data() + (size_t)k * batch;
+                        double sum = 0.0;
+                        for (int j = 0; j < batch; ++j) {
+                            sum += dzr[j] * xk[j];
+                        }
+                        dW[r * cols + k] = sum;
+                    }
+                }
+            });
+            parallel_for(0, cols, rows_per_chunk((int64_t)rows * batch), [&](int64_t first, int64_t last) {
+                for (int64_t k = first; k < last; ++k) {
+                    double* dk = dxh.data() + k * batch;
+                    for (int r = 0; r < rows; ++r) {
+                        if (k < s.spans[r].begin || k >= s.spans[r].end) {
+                            continue;
+                        }
+                        double w = W[(size_t)r * cols + k];
+                        const double* dzr = dz.data() + (size_t)r * batch;
+                        for (int j = 0; j < batch; ++j) {
+                            dk[j] += w * dzr[j];
+                        }
+                    }
+                }
+            });
+        }
+
+        // Adds grads[n] into parents[offset + n] for every parent that requires grad.
+        void accumulate(const std::vector<std::shared_ptr<Value>>& parents, size_t offset, const double* grads, size_t count) {
+            for (size_t n = 0; n < count; ++n) {
+                auto& parent = parents[offset + n];
+                if (parent->requires_grad) {
+                    grad_ref(parent.get()) += grads[n];
+                }
+            }
+        }
+
+        // Packs x and h into [x; h] and fills in the parts of the state every cell shares.
+        std::shared_ptr<StepState> begin_step(int in, int hidden, const std::shared_ptr<Tensor>& x, const std::shared_ptr<Tensor>& h) {
+            int batch = x->shape[1];
+            check_shape(x, in, batch, "x must be (input_size, batch)");
+            check_shape(h, hidden, batch, "h must be (hidden_size, batch)");
+            auto s = std::make_shared<StepState>();
+            s->in = in;
+            s->hidden = hidden;
+            s->batch = batch;
+            s->xh = std::vector<double>((size_t)(in + hidden) * batch);
+            for (size_t n = 0; n < x->values.size(); ++n) {
+                s->xh[n] = x->values[n]->value;
+            }
+            for (size_t n = 0; n < h->values.size(); ++n) {
+                s->xh[x->values.size() + n] = h->values[n]->value;
+            }
+            return s;
+        }
+
+        // Output tensor (H, batch) of a step; when recording, each value hangs off the hub and
+        // hands its gradient to it at position begin + n of the step's total outputs (h' then,
+        // for LSTM, c'), so the hub only sees outputs the current pass reached.
+        std::shared_ptr<Tensor> make_outputs(const std::vector<double>& values, size_t begin, int hidden, int batch, const std::shared_ptr<Value>& hub, size_t total) {
+            auto out = std::make_shared<Tensor>();
+            out->shape = {hidden, batch};
+            out->values.reserve((size_t)hidden * batch);
+            for (size_t n = 0; n < (size_t)hidden * batch; ++n) {
+                auto node = std::make_shared<Value>();
+                node->value = values[begin + n];
+                if (hub == nullptr) {
+                    node->requires_grad = false;
+                } else {
+                    node->parents.push_back(hub);
+                    node->grad_fn = [raw = node.get(), hub = hub.get(), idx = begin + n, total]() {
+                        hub_grads(hub, total)[idx] += grad_ref(raw);
+                    };
+                }
+                out->values.push_back(node);
+            }
+            return out;
+        }
+
+        std::shared_ptr<Value> make_hub(std::initializer_list<const std::vector<std::shared_ptr<Value>>*> sources) {
+            auto hub = std::make_shared<Value>();
+            size_t total = 0;
+            for (auto source : sources) {
+                total += source->size();
+            }
+            hub->parents.reserve(total);
+            for (auto source : sources) {
+                hub->parents.insert(hub->parents.end(), source->begin(), source->end());
+            }
+            return hub;
+        }
+
+        std::vector<float> uniform_init(size_t count, int hidden, std::mt19937& gen) {
+            double bound = 1.0 / std::sqrt((double)std::max(1, hidden));
+            auto dist = std::uniform_real_distribution<double>(-bound, bound);
+            auto data = std::vector<float>(count);
+            for (auto& v : data) {
+                v = (float)dist(gen);
+            }
+            return data;
+        }
+
+        // Steps [0, T) in windows; advance(t) runs step t and returns the new h, detach_state()
+        // cuts the carried state off from the finished window.
+        double run_windows(int steps, int window, const std::function<std::shared_ptr<Tensor>(int)>& advance, const std::function<void()>& detach_state, const StepLossFn& step_loss, const WindowEndFn& on_window_end) {
+            if (window < 1) {
+                throw std::invalid_argument("truncated_bptt: window must be at least 1");
+            }
+            double total = 0.0;
+            for (int first = 0; first < steps; first += window) {
+                int end = std::min(steps, first + window);
+                std::shared_ptr<Value> window_loss = nullptr;
+                for (int t = first; t < end; ++t) {
+                    auto h = advance(t);
+                    auto loss = step_loss(t, h);
+                    if (loss != nullptr) {
+                        window_loss = window_loss ? add(window_loss, loss) : loss;
+                    }
+                }
+                double value = window_loss ? window_loss->value : 0.0;
+                if (window_loss != nullptr) {
+                    backward(window_loss);
+                }
+                if (on_window_end) {
+                    on_window_end(first, end, value);
+                }
+                detach_state();
+                total += value;
+            }
+            return total;
+        }
+    }
+
+    RNNCell rnn_cell(int input_size, int hidden_size, unsigned seed) {
+        auto gen = std::mt19937(seed);
+        int cols = input_size + hidden_size;
+        RNNCell cell;
+        cell.input_size = input_size;
+        cell.hidden_size = hidden_size;
+        cell.W = create_tensor(uniform_init((size_t)hidden_size * cols, hidden_size, gen), hidden_size, cols);
+        cell.b = create_tensor(std::vector<float>((size_t)hidden_size, 0.0f), hidden_size, 1);
+        return cell;
+    }
+
+    LSTMCell lstm_cell(int input_size, int hidden_size, unsigned seed) {
+        auto gen = std::mt19937(seed);
+        int cols = input_size + hidden_size;
+        LSTMCell cell;
+        cell.input_size = input_size;
+        cell.hidden_size = hidden_size;
+        cell.W = create_tensor(uniform_init((size_t)4 * hidden_size * cols, hidden_size, gen), 4 * hidden_size, cols);
+        auto bias = std::vector<float>((size_t)4 * hidden_size, 0.0f);
+        std::fill(bias.begin() + hidden_size, bias.begin() + 2 * hidden_size, 1.0f);
+        cell.b = create_tensor(bias, 4 * hidden_size, 1);
+        return cell;
+    }
+
+    GRUCell gru_cell(int input_size, int hidden_size, unsigned seed) {
+        auto gen = std::mt19937(seed);
+        int H = hidden_size;
+        int cols = input_size + H;
+        auto weights = uniform_init((size_t)4 * H * cols, H, gen);
+        for (int r = 2 * H; r < 4 * H; ++r) {
+            int zero_begin = r < 3 * H ? input_size : 0;
+            int zero_end = r < 3 * H ? cols : input_size;
+            std::fill(weights.begin() + (size_t)r * cols + zero_begin, weights.begin() + (size_t)r * cols + zero_end, 0.0f);
+        }
+        GRUCell cell;
+        cell.input_size = input_size;
+        cell.hidden_size = H;
+        cell.W = create_tensor(weights, 4 * H, cols);
+        cell.b = create_tensor(std::vector<float>((size_t)4 * H, 0.0f), 4 * H, 1);
+        return cell;
+    }
+
+    std::shared_ptr<Tensor> rnn_zero_state(const RNNCell& cell, int batch) {
+        return create_tensor(std::vector<float>((size_t)cell.hidden_size * batch, 0.0f), cell.hidden_size, batch, false);
+    }
+
+    LSTMState lstm_zero_state(const LSTMCell& cell, int batch) {
+        auto zeros = std::vector<float>((size_t)cell.hidden_size * batch, 0.0f);
+        return {create_tensor(zeros, cell.hidden_size, batch, false), create_tensor(zeros, cell.hidden_size, batch, false)};
+    }
+
+    std::shared_ptr<Tensor> gru_zero_state(const GRUCell& cell, int batch) {
+        return create_tensor(std::vector<float>((size_t)cell.hidden_size * batch, 0.0f), cell.hidden_size, batch, false);
+    }
+
+    std::shared_ptr<Tensor> rnn_step(const RNNCell& cell, std::shared_ptr<Tensor> x, std::shared_ptr<Tensor> h) {
+        int in = cell.input_size, H = cell.hidden_size;
+        auto s = begin_step(in, H, x, h);
+        int batch = s->batch;
+        size_t n = (size_t)H * batch;
+        s->spans.assign(H, Span{0, in + H});
+
+        auto W = read_values(cell.W->values, 0, cell.W->values.size());
+        auto b = read_values(cell.b->values, 0, cell.b->values.size());
+        auto z = gate_gemm(W, b, *s);
+
+        // gates = h' = tanh(z).
+        s->gates = std::vector<double>(n);
+        for (size_t idx = 0; idx < n; ++idx) {
+            s->gates[idx] = std::tanh(z[idx]);
+        }
+
+        std::shared_ptr<Value> hub = nullptr;
+        if (is_grad_enabled()) {
+            hub = make_hub({&cell.W->values, &cell.b->values, &x->values, &h->values});
+        }
+        auto out = make_outputs(s->gates, 0, H, batch, hub, n);
+        if (hub == nullptr) {
+            return out;
+        }
+
+        auto raw = hub.get();
+        hub->grad_fn = [raw, s]() {
+            int in = s->in, H = s->hidden, batch = s->batch;
+            size_t n = (size_t)H * batch;
+            size_t w_size = (size_t)H * (in + H);
+            auto& parents = raw->parents;
+            auto dh = take_hub_grads(raw, n);
+            auto dz = std::vector<double>(n);
+            for (size_t idx = 0; idx < n; ++idx) {
+                double h = s->gates[idx];
+                dz[idx] = dh[idx] * (1.0 - h * h);
+            }
+            auto W = read_values(parents, 0, w_size);
+            std::vector<double> dW, db, dxh;
+            gate_gemm_backward(W, dz, *s, dW, db, dxh);
+
+            size_t offset = 0;
+            accumulate(parents, offset, dW.data(), w_size);
+            offset += w_size;
+            accumulate(parents, offset, db.data(), db.size());
+            offset += db.size();
+            accumulate(parents, offset, dxh.data(), dxh.size());
+        };
+        return out;
+    }
+
+    LSTMState lstm_step(const LSTMCell& cell, std::shared_ptr<Tensor> x, const LSTMState& state) {
+        int in = cell.input_size, H = cell.hidden_size;
+        auto s = begin_step(in, H, x, state.h);
+        int batch = s->batch;
+        check_shape(state.c, H, batch, "c must be (hidden_size, batch)");
+        size_t n = (size_t)H * batch;
+        s->spans.assign(4 * H, Span{0, in + H});
+
+        auto W = read_values(cell.W->values, 0, cell.W->values.size());
+        auto b = read_values(cell.b->values, 0, cell.b->values.size());
+        auto z = gate_gemm(W, b, *s);
+
+        // gates = [i, f, g, o]; next = [h', c']; aux = [c_prev, tanh(c')].
+        s->gates = std::vector<double>(4 * n);
+        s->aux = std::vector<double>(2 * n);
+        auto next = std::vector<double>(2 * n);
+        for (size_t idx = 0; idx < n; ++idx) {
+            double i = sigmoid(z[idx]);
+            double f = sigmoid(z[n + idx]);
+            double g = std::tanh(z[2 * n + idx]);
+            double o = sigmoid(z[3 * n + idx]);
+            double c_prev = state.c->values[idx]->value;
+            double c = f * c_prev + i * g;
+            double tc = std::tanh(c);
+            s->gates[idx] = i;
+            s->gates[n + idx] = f;
+            s->gates[2 * n + idx] = g;
+            s->gates[3 * n + idx] = o;
+            s->aux[idx] = c_prev;
+            s->aux[n + idx] = tc;
+            next[idx] = o * tc;
+            next[n + idx] = c;
+        }
+
+        std::shared_ptr<Value> hub = nullptr;
+        if (is_grad_enabled()) {
+            hub = make_hub({&cell.W->values, &cell.b->values, &x->values, &state.h->values, &state.c->values});
+        }
+        LSTMState out;
+        out.h = make_outputs(next, 0, H, batch, hub, 2 * n);
+        out.c = make_outputs(next, n, H, batch, hub, 2 * n);
+        if (hub == nullptr) {
+            return out;
+        }
+
+        auto raw = hub.get();
+        hub->grad_fn = [raw, s]() {
+            int in = s->in, H = s->hidden, batch = s->batch;
+            size_t n = (size_t)H * batch;
+            size_t w_size = (size_t)4 * H * (in + H);
+            auto& parents = raw->parents;
+            auto dhc = take_hub_grads(raw, 2 * n);
+            const double* dh = dhc.data();
+            const double* dc = dhc.data() + n;
+            auto& gates = s->gates;
+            auto dz = std::vector<double>(4 * n);
+            auto dc_prev = std::vector<double>(n);
+            for (size_t idx = 0; idx < n; ++idx) {
+                double i = gates[idx], f = gates[n + idx], g = gates[2 * n + idx], o = gates[3 * n + idx];
+                double tc = s->aux[n + idx];
+                double dct = dc[idx] + dh[idx] * o * (1.0 - tc * tc);
+                dz[idx] = dct * g * i * (1.0 - i);
+                dz[n + idx] = dct * s->aux[idx] * f * (1.0 - f);
+                dz[2 * n + idx] = dct * i * (1.0 - g * g);
+                dz[3 * n + idx] = dh[idx] * tc * o * (1.0 - o);
+                dc_prev[idx] = dct * f;
+            }
+            auto W = read_values(parents, 0, w_size);
+            std::vector<double> dW, db, dxh;
+            gate_gemm_backward(W, dz, *s, dW, db, dxh);
+
+            size_t offset = 0;
+            accumulate(parents, offset, dW.data(), w_size);
+            offset += w_size;
+            accumulate(parents, offset, db.data(), db.size());
+            offset += db.size();
+            accumulate(parents, offset, dxh.data(), dxh.size());
+            offset += dxh.size();
+            accumulate(parents, offset, dc_prev.data(), n);
+        };
+        return out;
+    }
+
+    std::shared_ptr<Tensor> gru_step(const GRUCell& cell, std::shared_ptr<Tensor> x, std::shared_ptr<Tensor> h) {
+        int in = cell.input_size, H = cell.hidden_size;
+        auto s = begin_step(in, H, x, h);
+        int batch = s->batch;
+        size_t n = (size_t)H * batch;
+        s->spans.assign(2 * H, Span{0, in + H});
+        s->spans.insert(s->spans.end(), H, Span{0, in});
+        s->spans.insert(s->spans.end(), H, Span{in, in + H});
+
+        auto W = read_values(cell.W->values, 0, cell.W->values.size());
+        auto b = read_values(cell.b->values, 0, cell.b->values.size());
+        auto z = gate_gemm(W, b, *s);
+
+        // gates = [r, u, n] (u is the update gate); aux = W_hn h + b_hn.
+        s->gates = std::vector<double>(3 * n);
+        s->aux = std::vector<double>(z.begin() + 3 * n, z.end());
+        auto next = std::vector<double>(n);
+        const double* h_prev = s->xh.data() + (size_t)in * batch;
+        for (size_t idx = 0; idx < n; ++idx) {
+            double r = sigmoid(z[idx]);
+            double u = sigmoid(z[n + idx]);
+            double cand = std::tanh(z[2 * n + idx] + r * s->aux[idx]);
+            s->gates[idx] = r;
+            s->gates[n + idx] = u;
+            s->gates[2 * n + idx] = cand;
+            next[idx] = (1.0 - u) * cand + u * h_prev[idx];
+        }
+
+        std::shared_ptr<Value> hub = nullptr;
+        if (is_grad_enabled()) {
+            hub = make_hub({&cell.W->values, &cell.b->values, &x->values, &h->values});
+        }
+        auto out = make_outputs(next, 0, H, batch, hub, n);
+        if (hub == nullptr) {
+            return out;
+        }
+
+        auto raw = hub.get();
+        hub->grad_fn = [raw, s]() {
+            int in = s->in, H = s->hidden, batch = s->batch;
+            size_t n = (size_t)H * batch;
+            size_t w_size = (size_t)4 * H * (in + H);
+            auto& parents = raw->parents;
+            auto dh = take_hub_grads(raw, n);
+            const double* h_prev = s->xh.data() + (size_t)in * batch;
+            auto dz = std::vector<double>(4 * n);
+            auto dh_direct = std::vector<double>(n);
+            for (size_t idx = 0; idx < n; ++idx) {
+                double r = s->gates[idx], u = s->gates[n + idx], cand = s->gates[2 * n + idx];
+                double da = dh[idx] * (1.0 - u) * (1.0 - cand * cand);
+                double du = dh[idx] * (h_prev[idx] - cand);
+                dz[idx] = da * s->aux[idx] * r * (1.0 - r);
+                dz[n + idx] = du * u * (1.0 - u);
+                dz[2 * n + idx] = da;
+                dz[3 * n + idx] = da * r;
+                dh_direct[idx] = dh[idx] * u;
+            }
+            auto W = read_values(parents, 0, w_size);
+            std::vector<double> dW, db, dxh;
+            gate_gemm_backward(W, dz, *s, dW, db, dxh);
+            for (size_t idx = 0; idx < n; ++idx) {
+                dxh[(size_t)in * batch + idx] += dh_direct[idx];
+            }
+
+            size_t offset = 0;
+            accumulate(parents, offset, dW.data(), w_size);
+            offset += w_size;
+            accumulate(parents, offset, db.data(), db.size());
+            offset += db.size();
+            accumulate(parents, offset, dxh.data(), dxh.size());
+        };
+        return out;
+    }
+
+    double truncated_bptt(const RNNCell& cell, const std::vector<std::shared_ptr<Tensor>>& inputs, std::shared_ptr<Tensor>& h, int window, const StepLossFn& step_loss, const WindowEndFn& on_window_end) {
+        auto advance = [&](int t) {
+            h = rnn_step(cell, inputs[t], h);
+            return h;
+        };
+        auto detach_state = [&]() {
+            h = detach(h);
+        };
+        return run_windows((int)inputs.size(), window, advance, detach_state, step_loss, on_window_end);
+    }
+
+    double truncated_bptt(const LSTMCell& cell, const std::vector<std::shared_ptr<Tensor>>& inputs, LSTMState& state, int window, const StepLossFn& step_loss, const WindowEndFn& on_window_end) {
+        auto advance = [&](int t) {
+            state = lstm_step(cell, inputs[t], state);
+            return state.h;
+        };
+        auto detach_state = [&]() {
+            state = {detach(state.h), detach(state.c)};
+        };
+        return run_windows((int)inputs.size(), window, advance, detach_state, step_loss, on_window_end);
+    }
+
+    double truncated_bptt(const GRUCell& cell, const std::vector<std::shared_ptr<Tensor>>& inputs, std::shared_ptr<Tensor>& h, int window, const StepLossFn& step_loss, const WindowEndFn& on_window_end) {
+        auto advance = [&](int t) {
+            h = gru_step(cell, inputs[t], h);
+            return h;
+        };
+        auto detach_state = [&]() {
+            h = detach(h);
+        };
+        return run_windows((int)inputs.size(), window, advance, detach_state, step_loss, on_window_end);
+    }
+}
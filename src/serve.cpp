@@ -0,0 +1,72 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "autograd/inference.hpp"
+
+using namespace autograd;
+
+// Example server: loads a model (or builds a random 64-128-10 MLP) and drives the inference
+// engine with a closed-loop load generator standing in for real clients.
+//
+//   ./autograd_serve [model_file] [clients] [requests_per_client]
+int main(int argc, char** argv) {
+    Model model;
+    if (argc > 1 && std::string(argv[1]) != "-") {
+        model = load_model(argv[1]);
+    } else {
+        std::mt19937 rng(0);
+        std::normal_distribution<double> dist(0.0, 0.1);
+        for (auto dims : {std::pair<int, int>{64, 128}, std::pair<int, int>{128, 10}}) {
+            DenseLayer layer;
+            layer.in_features = dims.first;
+            layer.out_features = dims.second;
+            layer.relu = dims.second != 10;
+            for (int i = 0; i < dims.first * dims.second; ++i) layer.weight.push_back(dist(rng));
+            for (int i = 0; i < dims.second; ++i) layer.bias.push_back(dist(rng));
+            model.layers.push_back(layer);
+        }
+    }
+    int clients = argc > 2 ? std::stoi(argv[2]) : 8;
+    int requests_per_client = argc > 3 ? std::stoi(argv[3]) : 2000;
+
+    EngineOptions options;
+    options.max_batch_size = 32;
+    options.max_wait = std::chrono::microseconds(500);
+    InferenceEngine engine(model, options);
+
+    std::cout << "Serving a " << model.input_size() << " -> " << model.output_size() << " model to "
+              << clients << " clients x " << requests_per_client << " requests\n";
+
+    auto start = std::chrono::steady_clock::now();
+    auto threads = std::vector<std::thread>();
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c]() {
+            std::mt19937 rng(c + 1);
+            std::uniform_real_distribution<double> dist(-1.0, 1.0);
+            auto input = std::vector<double>(model.input_size());
+            for (int r = 0; r < requests_per_client; ++r) {
+                for (auto& v : input) v = dist(rng);
+                engine.submit(input).get();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto stats = engine.stats();
+    std::cout << "throughput   : " << stats.requests / seconds << " requests/s\n";
+    std::cout << "latency p50  : " << stats.p50_latency_us << " us\n";
+    std::cout << "latency p99  : " << stats.p99_latency_us << " us\n";
+    std::cout << "batches      : " << stats.batches << " (mean size " << (double)stats.requests / stats.batches << ")\n";
+    std::cout << "batch sizes  :\n";
+    for (size_t size = 1; size < stats.batch_size_histogram.size(); ++size) {
+        if (stats.batch_size_histogram[size] != 0) {
+            std::cout << "  " << size << ": " << stats.batch_size_histogram[size] << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "autograd/sparse.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/grad_store.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace autograd {
+    std::shared_ptr<SparseCOO> create_sparse_coo(std::vector<int> row_indices, std::vector<int> col_indices, std::vector<float> data, int rows, int cols, bool requires_grad) {
+        if (row_indices.size() != col_indices.size() || row_indices.size() != data.size()) {
+            throw std::invalid_argument("COO index and data arrays must have the same length");
+        }
+        auto out = std::make_shared<SparseCOO>();
+        out->shape = {rows, cols};
+        for (size_t n = 0; n < data.size(); ++n) {
+            if (row_indices[n] < 0 || row_indices[n] >= rows || col_indices[n] < 0 || col_indices[n] >= cols) {
+                throw std::invalid_argument("COO index out of range");
+            }
+            auto val = std::make_shared<Value>();
+            val->value = data[n];
+            val->grad = 0.0;
+            val->requires_grad = requires_grad;
+            out->values.push_back(val);
+        }
+        out->row_indices = std::move(row_indices);
+        out->col_indices = std::move(col_indices);
+        return out;
+    }
+
+    std::shared_ptr<SparseCOO> sparse_from_dense(std::shared_ptr<Tensor> A) {
+        // Nonzero entries keep pointing at A's nodes, so gradients flow back into A.
+        auto out = std::make_shared<SparseCOO>();
+        out->shape = A->shape;
+        for (int i = 0; i < A->shape[0]; ++i) {
+            for (int j = 0; j < A->shape[1]; ++j) {
+                auto& val = A->values[i * A->shape[1] + j];
+                if (val->value != 0.0) {
+                    out->row_indices.push_back(i);
+                    out->col_indices.push_back(j);
+                    out->values.push_back(val);
+                }
+            }
+        }
+        return out;
+    }
+
+    std::shared_ptr<SparseCSR> to_csr(std::shared_ptr<SparseCOO> A) {
+        int rows = A->shape[0];
+        auto out = std::make_shared<SparseCSR>();
+        out->shape = A->shape;
+        out->row_ptr = std::vector<int>(rows + 1, 0);
+        for (int r : A->row_indices) {
+            out->row_ptr[r + 1]++;
+        }
+        for (int i = 0; i < rows; ++i) {
+            out->row_ptr[i + 1] += out->row_ptr[i];
+        }
+        // Stable counting sort by row; duplicates are kept and simply sum in matmul.
+        auto nnz = A->values.size();
+        out->col_indices = std::vector<int>(nnz);
+        out->values = std::vector<std::shared_ptr<Value>>(nnz);
+        auto next = std::vector<int>(out->row_ptr.begin(), out->row_ptr.end() - 1);
+        for (size_t n = 0; n < nnz; ++n) {
+            int slot = next[A->row_indices[n]]++;
+            out->col_indices[slot] = A->col_indices[n];
+            out->values[slot] = A->values[n];
+        }
+        return out;
+    }
+
+    std::shared_ptr<SparseCOO> to_coo(std::shared_ptr<SparseCSR> A) {
+        auto out = std::make_shared<SparseCOO>();
+        out->shape = A->shape;
+        out->col_indices = A->col_indices;
+        out->values = A->values;
+        for (int i = 0; i < A->shape[0]; ++i) {
+            for (int p = A->row_ptr[i]; p < A->row_ptr[i + 1]; ++p) {
+                out->row_indices.push_back(i);
+            }
+        }
+        return out;
+    }
+
+    std::shared_ptr<Tensor> matmul(std::shared_ptr<SparseCSR> a, std::shared_ptr<Tensor> b) {
+        if (a->shape[1] != b->shape[0]) {
+            throw std::invalid_argument("Incompatible tensor shapes for sparse matrix multiplication");
+        }
+        auto out = std::make_shared<Tensor>();
+        out->shape = {a->shape[0], b->shape[1]};
+        int cols = b->shape[1];
+
+        for (int i = 0; i < a->shape[0]; ++i) {
+            int begin = a->row_ptr[i];
+            int nnz = a->row_ptr[i + 1] - begin;
+            for (int j = 0; j < cols; ++j) {
+                auto node = std::make_shared<Value>();
+                if (nnz == 0) {
+                    // Empty row: the output is a constant zero with nothing to backpropagate into.
+                    node->requires_grad = false;
+                    out->values.push_back(node);
+                    continue;
+                }
+                double sum = 0.0;
+                for (int p = begin; p < begin + nnz; ++p) {
+                    sum += a->values[p]->value * b->values[a->col_indices[p] * cols + j]->value;
+                }
+                node->value = sum;
+                if (!is_grad_enabled()) {
+                    node->requires_grad = false;
+                    out->values.push_back(node);
+                    continue;
+                }
+                // One fused node per output: parents[0, nnz) are a's row, parents[nnz, 2 * nnz) the matching b entries.
+                node->parents.reserve(2 * nnz);
+                for (int p = begin; p < begin + nnz; ++p) {
+                    node->parents.push_back(a->values[p]);
+                }
+                for (int p = begin; p < begin + nnz; ++p) {
+                    node->parents.push_back(b->values[a->col_indices[p] * cols + j]);
+                }
+
+                auto raw = node.get();
+                node->grad_fn = [raw, nnz]() {
+                    auto& parents = raw->parents;
+                    double g = grad_ref(raw);
+                    for (int p = 0; p < nnz; ++p) {
+                        if (parents[p]->requires_grad) {
+                            grad_ref(parents[p].get()) += g * parents[nnz + p]->value;
+                        }
+                        if (parents[nnz + p]->requires_grad) {
+                            grad_ref(parents[nnz + p].get()) += g * parents[p]->value;
+                        }
+                    }
+                };
+                node->vjp_fn = [raw, nnz](std::shared_ptr<Value> g) {
+                    auto& parents = raw->parents;
+                    std::vector<std::shared_ptr<Value>> grads(2 * nnz);
+                    for (int p = 0; p < nnz; ++p) {
+                        grads[p] = mult(g, parents[nnz + p]);
+                        grads[nnz + p] = mult(g, parents[p]);
+                    }
+                    return grads;
+                };
+                out->values.push_back(node);
+            }
+        }
+        return out;
+    }
+
+    std::shared_ptr<Tensor> matmul(std::shared_ptr<SparseCOO> a, std::shared_ptr<Tensor> b) {
+        return matmul(to_csr(a), b);
+    }
+
+    std::shared_ptr<Embedding> create_embedding(std::vector<float> data, int num_embeddings, int dim) {
+        auto table = std::make_shared<Embedding>();
+        table->weight = create_tensor(data, num_embeddings, dim);
+        return table;
+    }
+
+    std::shared_ptr<Tensor> embedding_lookup(std::shared_ptr<Embedding> table, const std::vector<int>& ids) {
+        int rows = table->weight->shape[0];
+        int dim = table->weight->shape[1];
+        auto out = std::make_shared<Tensor>();
+        out->shape = {(int)ids.size(), dim};
+        out->values.reserve(ids.size() * dim);
+        for (int id : ids) {
+            if (id < 0 || id >= rows) {
+                throw std::invalid_argument("Embedding index out of range");
+            }
+            for (int j = 0; j < dim; ++j) {
+                out->values.push_back(table->weight->values[id * dim + j]);
+            }
+            // Inference lookups (NoGradGuard) never produce a gradient for the row.
+            if (is_grad_enabled()) {
+                table->touched_rows.push_back(id);
+            }
+        }
+        return out;
+    }
+
+    RowSparseGrad sparse_grad(std::shared_ptr<Embedding> table) {
+        RowSparseGrad out;
+        out.dim = table->weight->shape[1];
+        out.rows = table->touched_rows;
+        std::sort(out.rows.begin(), out.rows.end());
+        out.rows.erase(std::unique(out.rows.begin(), out.rows.end()), out.rows.end());
+        out.values.reserve(out.rows.size() * out.dim);
+        for (int r : out.rows) {
+            for (int j = 0; j < out.dim; ++j) {
+                out.values.push_back(table->weight->values[r * out.dim + j]->grad);
+            }
+        }
+        return out;
+    }
+}
@@ -1,23 +1,26 @@
 #include "autograd/tensor.hpp"
+#include "autograd/parallel.hpp"
 
 namespace autograd {
     // Tensor uses default constructor - no implementation needed
     std::vector<std::shared_ptr<Value>> create_matrix(std::vector<float> data, int rows, int cols, bool requires_grad) {
-        std::vector<std::shared_ptr<Value>> matrix;
-        for (int i = 0; i < rows * cols; ++i) {
-            auto val = std::make_shared<Value>();
-            val->value = data[i];
-            val->grad = 0.0;
-            val->requires_grad = true;
-            matrix.push_back(val);
-        }
+        std::vector<std::shared_ptr<Value>> matrix((size_t)rows * cols);
+        parallel_for(0, (int64_t)rows * cols, 4096, [&](int64_t first, int64_t last) {
+            for (int64_t i = first; i < last; ++i) {
+                auto val = std::make_shared<Value>();
+                val->value = data[i];
+                val->grad = 0.0;
+                val->requires_grad = requires_grad;
+                matrix[i] = val;
+            }
+        });
         return matrix;
     }
 
     std::shared_ptr<Tensor> create_tensor(std::vector<float> data, int rows, int cols, bool requires_grad) {
         auto tensor = std::make_shared<Tensor>();
         tensor->shape = {rows, cols};
-        tensor->values = create_matrix(data, rows, cols);
+        tensor->values = create_matrix(data, rows, cols, requires_grad);
         return tensor;
     }
 
@@ -27,11 +30,26 @@ namespace autograd {
         auto transposed = std::make_shared<Tensor>();
         transposed->shape = {cols, rows};
         transposed->values = std::vector<std::shared_ptr<Value>>(rows * cols);
-        for (int i = 0; i < A->shape[0]; ++i) {
-            for (int j = 0; j < A->shape[1]; ++j) {
-                transposed->values[j * A->shape[0] + i] = A->values[i * A->shape[1] + j] ;
+        parallel_for(0, rows, std::max(1, 16384 / std::max(1, cols)), [&](int64_t first, int64_t last) {
+            for (int64_t i = first; i < last; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    transposed->values[j * rows + i] = A->values[i * cols + j];
+                }
             }
-        }
+        });
         return transposed;
     }
+
+    std::shared_ptr<Tensor> detach(std::shared_ptr<Tensor> A) {
+        auto out = std::make_shared<Tensor>();
+        out->shape = A->shape;
+        out->values.reserve(A->values.size());
+        for (auto& v : A->values) {
+            auto val = std::make_shared<Value>();
+            val->value = v->value;
+            val->requires_grad = false;
+            out->values.push_back(val);
+        }
+        return out;
+    }
 }
@@ -2,6 +2,28 @@
 
 namespace autograd {
 
-    Value::Value() noexcept : value(0.0), grad(0.0), parents(), grad_fn(nullptr) {}
+    Value::Value() noexcept : value(0.0), grad(0.0), parents(), grad_fn(nullptr), vjp_fn(nullptr) {}
+
+    // Releasing a long chain (an unrolled sequence) node by node through the default destructors
+    // would recurse once per node. Instead, ancestors only this node still owns are emptied here
+    // and dropped one at a time, so each of their destructors has nothing left to walk.
+    Value::~Value() {
+        auto pending = std::move(parents);
+        grad_fn = nullptr;
+        vjp_fn = nullptr;
+        while (!pending.empty()) {
+            auto node = std::move(pending.back());
+            pending.pop_back();
+            if (node.use_count() != 1) {
+                continue;
+            }
+            for (auto& parent : node->parents) {
+                pending.push_back(std::move(parent));
+            }
+            node->parents.clear();
+            node->grad_fn = nullptr;
+            node->vjp_fn = nullptr;
+        }
+    }
     
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <memory>
+#include <array>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/activations.hpp"
+#include "autograd/expr.hpp"
+using namespace autograd;
+
+int main() {
+    std::cout << "=== Test 1: README example y = x * w + 5 ===\n";
+    {
+        auto x = expr::var<0>();
+        auto w = expr::var<1>();
+        auto f = x * w + 5.0;
+
+        std::array<double, 2> in{2.0, 3.0};
+        std::array<double, 2> grad;
+        double y = expr::value_and_grad(f, in, grad);
+
+        std::cout << "y = " << y << " (expected 11)\n";
+        std::cout << "dy/dx = " << grad[0] << " (expected 3)\n";
+        std::cout << "dy/dw = " << grad[1] << " (expected 2)\n\n";
+    }
+
+    std::cout << "=== Test 2: Softmax-like term matches the dynamic graph ===\n";
+    {
+        // f = exp(a) / (exp(a) + exp(b)) - log(a * b)
+        auto a = expr::var<0>();
+        auto b = expr::var<1>();
+        auto f = expr::exp(a) / (expr::exp(a) + expr::exp(b)) - expr::log(a * b);
+
+        std::array<double, 2> in{1.5, 0.5};
+        std::array<double, 2> grad;
+        double y = expr::value_and_grad(f, in, grad);
+
+        auto da = constant(1.5);
+        auto db = constant(0.5);
+        auto dy = sub(div(exp(da), add(exp(da), exp(db))), log(mult(da, db)));
+        backward(dy);
+
+        std::cout << "static  f = " << y << ", grad = " << grad[0] << " " << grad[1] << "\n";
+        std::cout << "dynamic f = " << dy->value << ", grad = " << da->grad << " " << db->grad << " (should match)\n\n";
+    }
+
+    std::cout << "=== Test 3: Per-element loss with relu and max ===\n";
+    {
+        // hinge-like: relu(1 - y * p) + 0.5 * max(p, 2 - p)
+        auto p = expr::var<0>();
+        auto y = expr::var<1>();
+        auto f = expr::relu(1.0 - y * p) + 0.5 * expr::max(p, 2.0 - p);
+
+        std::array<double, 2> grad;
+        for (double pv : {-0.5, 0.25, 1.0, 3.0}) {
+            std::array<double, 2> in{pv, 1.0};
+            double v = expr::value_and_grad(f, in, grad);
+
+            auto dp = constant(pv);
+            auto dyv = constant(1.0);
+            auto half = constant(0.5);
+            auto dv = add(relu(sub(constant(1.0), mult(dyv, dp))), mult(half, max(dp, sub(constant(2.0), dp))));
+            backward(dv);
+
+            std::cout << "p = " << pv << ": static " << v << " / " << grad[0] << " " << grad[1]
+                      << ", dynamic " << dv->value << " / " << dp->grad << " " << dyv->grad << "\n";
+        }
+        std::cout << "(static and dynamic columns should match)\n\n";
+    }
+
+    std::cout << "=== Test 4: Hot loop ===\n";
+    {
+        auto x = expr::var<0>();
+        auto f = expr::log(1.0 + expr::exp(x * -1.0));
+
+        std::array<double, 1> in;
+        std::array<double, 1> grad;
+        double total = 0.0;
+        for (int i = 0; i < 1000000; ++i) {
+            in[0] = (i % 200) * 0.01 - 1.0;
+            expr::value_and_grad(f, in, grad);
+            total += grad[0];
+        }
+        std::cout << "sum of gradients = " << total << " (expected -501155)\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/grad_store.hpp"
+#include "autograd/activations.hpp"
+#include "autograd/tensor.hpp"
+using namespace autograd;
+
+int main() {
+    std::cout << "=== Test 1: Requested inputs only ===\n";
+    {
+        // f = x * y + exp(x)
+        auto x = constant(1.0);
+        auto y = constant(2.0);
+        auto f = add(mult(x, y), exp(x));
+        x->grad = 42.0;
+        y->grad = 42.0;
+        auto g = grad({f}, {x});
+        std::cout << "df/dx = " << g[0] << " (expected " << 2.0 + std::exp(1.0) << ")\n";
+        std::cout << "x.grad = " << x->grad << " (expected 42)\n";
+        std::cout << "y.grad = " << y->grad << " (expected 42)\n";
+        std::cout << "f.grad = " << f->grad << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 2: Pruned branches ===\n";
+    {
+        // loss = w * x + frozen, where frozen hangs off a leaf nobody asks about.
+        int calls = 0;
+        auto w = constant(0.5);
+        auto x = constant(3.0);
+        auto c = constant(1.0);
+        auto frozen = std::make_shared<Value>();
+        frozen->value = 2.0 * c->value;
+        frozen->parents.push_back(c);
+        auto raw = frozen.get();
+        frozen->grad_fn = [raw, &calls]() {
+            calls += 1;
+            grad_ref(raw->parents[0].get()) += 2.0 * grad_ref(raw);
+        };
+        auto loss = add(mult(w, x), frozen);
+
+        auto g = grad({loss}, {w});
+        std::cout << "dloss/dw = " << g[0] << " (expected 3)\n";
+        std::cout << "frozen grad_fn calls = " << calls << " (expected 0)\n";
+        std::cout << "c.grad = " << c->grad << " (expected 0)\n";
+        backward(loss);
+        std::cout << "after backward: calls = " << calls << ", c.grad = " << c->grad << " (expected 1, 2)\n\n";
+    }
+
+    std::cout << "=== Test 3: Several outputs with seeds ===\n";
+    {
+        // 2 * (x * y) + 3 * (x + y)
+        auto x = constant(1.5);
+        auto y = constant(-2.0);
+        auto a = mult(x, y);
+        auto b = add(x, y);
+        auto g = grad({a, b}, {x, y}, {2.0, 3.0});
+        std::cout << "dx = " << g[0] << " (expected -1)\n";
+        std::cout << "dy = " << g[1] << " (expected 6)\n";
+        auto repeated = grad({a, a}, {x});
+        std::cout << "same output twice: dx = " << repeated[0] << " (expected -4)\n\n";
+    }
+
+    std::cout << "=== Test 4: Layer with frozen inputs ===\n";
+    {
+        auto weights = create_tensor({0.2, 0.8, -0.5, 1.0}, 2, 2);
+        auto inputs = create_tensor({1.0, 2.0}, 2, 1, false);
+        auto bias = create_tensor({0.5, -1.0}, 2, 1);
+        auto output = addBias(matmul(weights, inputs), bias);
+        auto loss = add(relu(output->values[0]), relu(output->values[1]));
+
+        auto g = grad({loss}, {weights, bias});
+        std::cout << "dW = " << g[0][0] << " " << g[0][1] << " " << g[0][2] << " " << g[0][3] << " (expected 1 2 1 2)\n";
+        std::cout << "db = " << g[1][0] << " " << g[1][1] << " (expected 1 1)\n";
+        std::cout << "weights grad untouched: " << weights->values[0]->grad << " (expected 0)\n";
+        auto g_in = grad({loss}, {inputs});
+        std::cout << "d/d inputs (requires_grad=false) = " << g_in[0][0] << " " << g_in[0][1] << " (expected 0 0)\n\n";
+    }
+
+    std::cout << "=== Test 5: Edge cases ===\n";
+    {
+        auto x = constant(2.0);
+        auto unrelated = constant(5.0);
+        auto f = mult(x, x);
+        auto g = grad({f}, {unrelated, f});
+        std::cout << "unrelated input = " << g[0] << " (expected 0)\n";
+        std::cout << "output itself = " << g[1] << " (expected 1)\n";
+        try {
+            grad({f}, {x}, {1.0, 2.0});
+            std::cout << "no exception (expected exception)\n";
+        } catch (const std::invalid_argument&) {
+            std::cout << "caught invalid_argument (expected exception)\n";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "=== Test 6: Stale gradients on other matmul outputs ===\n";
+    {
+        // Y[1] keeps the gradient of an earlier backward(); dY[0]/dW only involves W's first row.
+        auto W = create_tensor({1.0, 2.0, 3.0, 4.0}, 2, 2);
+        auto X = create_tensor({1.0, 1.0}, 2, 1, false);
+        auto Y = matmul(W, X);
+        backward(Y->values[1]);
+        auto g = grad({Y->values[0]}, {W});
+        std::cout << "dW = " << g[0][0] << " " << g[0][1] << " " << g[0][2] << " " << g[0][3] << " (expected 1 1 0 0)\n";
+        std::cout << "W grad untouched = " << W->values[2]->grad << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 7: Concurrent calls on one graph ===\n";
+    {
+        // Each thread asks for a different output's gradient; neither sees the other's pass.
+        auto W = create_tensor({0.5, -1.0, 2.0, 0.25}, 2, 2);
+        auto X = create_tensor({1.0, 2.0, 3.0, 4.0}, 2, 2, false);
+        auto Y = matmul(W, X);
+        auto l0 = mult(Y->values[0], Y->values[1]);
+        auto l1 = mult(Y->values[2], Y->values[3]);
+        auto e0 = grad({l0}, {W})[0];
+        auto e1 = grad({l1}, {W})[0];
+        bool same = true;
+        auto worker = [&](std::shared_ptr<Value> loss, const std::vector<double>& expected) {
+            for (int round = 0; round < 200; ++round) {
+                if (grad({loss}, {W})[0] != expected) {
+                    same = false;
+                }
+            }
+        };
+        std::thread t0(worker, l0, e0);
+        std::thread t1(worker, l1, e1);
+        t0.join();
+        t1.join();
+        std::cout << "results match serial calls: " << same << " (expected 1)\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <memory>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/activations.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/gradcheck.hpp"
+using namespace autograd;
+
+// Same toy layer as test_finite_diffference_gradient.cpp: relu(W^T x + b) summed.
+std::shared_ptr<Value> toy_loss(const std::vector<std::shared_ptr<Tensor>>& t) {
+    auto output = addBias(matmul(transpose(t[0]), t[1]), t[2]);
+    return add(relu(output->values[0]), relu(output->values[1]));
+}
+
+// x * x with a deliberately wrong backward rule (missing the factor 2).
+std::shared_ptr<Value> bad_square(std::shared_ptr<Value> x) {
+    auto out = std::make_shared<Value>();
+    out->value = x->value * x->value;
+    if (!is_grad_enabled()) {
+        return out;
+    }
+    out->parents.push_back(x);
+    auto raw = out.get();
+    out->grad_fn = [x, raw]() {
+        x->grad += raw->grad * x->value;
+    };
+    return out;
+}
+
+void print_report(const GradcheckReport& report) {
+    for (const auto& t : report.tensors) {
+        std::cout << "  input " << t.index << ": checked " << t.checked
+                  << ", max abs " << t.max_abs_error
+                  << ", max rel " << t.max_rel_error
+                  << (t.passed ? " (pass)" : " (FAIL)") << "\n";
+    }
+    std::cout << "  overall: " << (report.passed ? "pass" : "FAIL") << "\n";
+}
+
+int main() {
+    std::cout << "=== Test 1: No-grad mode records nothing ===\n";
+    {
+        auto x = std::make_shared<Value>();
+        x->value = 2.0;
+        NoGradGuard no_grad;
+        auto y = mult(x, exp(x));
+        std::cout << "parents = " << y->parents.size() << " (expected 0)\n";
+        std::cout << "has grad_fn = " << (y->grad_fn != nullptr) << " (expected 0)\n\n";
+    }
+
+    auto weights = create_tensor({0.2, 0.8, -0.5, 1.0}, 2, 2);
+    auto inputs  = create_tensor({1.0, 2.0}, 2, 1, false);
+    auto bias    = create_tensor({0.5, -1.0}, 2, 1);
+
+    std::cout << "=== Test 2: Elementwise gradcheck on the toy layer ===\n";
+    {
+        GradcheckOptions options;
+        options.num_threads = 4;
+        auto report = gradcheck(toy_loss, {weights, inputs, bias}, options);
+        print_report(report);
+        std::cout << "(expected inputs 0 and 2 checked, overall pass)\n\n";
+    }
+
+    std::cout << "=== Test 3: Directional gradcheck ===\n";
+    {
+        GradcheckOptions options;
+        options.directional = true;
+        options.num_directions = 3;
+        options.seed = 7;
+        auto report = gradcheck(toy_loss, {weights, inputs, bias}, options);
+        print_report(report);
+        std::cout << "(expected 3 directions per checked input, overall pass)\n";
+        std::cout << "weight grad untouched = " << weights->values[0]->grad << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 4: Broken backward rule is reported ===\n";
+    {
+        auto x = create_tensor({1.5, -0.5, 3.0}, 3, 1);
+        auto sum_of_squares = [](const std::vector<std::shared_ptr<Tensor>>& t) {
+            auto loss = bad_square(t[0]->values[0]);
+            for (size_t i = 1; i < t[0]->values.size(); ++i) {
+                loss = add(loss, bad_square(t[0]->values[i]));
+            }
+            return loss;
+        };
+        auto report = gradcheck(sum_of_squares, {x});
+        print_report(report);
+        std::cout << "(expected FAIL with max rel 0.5)\n\n";
+    }
+
+    std::cout << "=== Test 5: Tensor with frozen elements ===\n";
+    {
+        // Only p[0] is trainable; the frozen p[1] must not be probed or perturbed, since its
+        // analytic gradient stays 0 while the loss depends on it.
+        auto p = create_tensor({1.5, -2.0}, 2, 1);
+        p->values[1]->requires_grad = false;
+        auto loss = [](const std::vector<std::shared_ptr<Tensor>>& t) {
+            auto a = t[0]->values[0], b = t[0]->values[1];
+            return add(mult(a, b), mult(b, b));
+        };
+        auto report = gradcheck(loss, {p});
+        print_report(report);
+        std::cout << "(expected 1 element checked, overall pass)\n";
+
+        GradcheckOptions options;
+        options.directional = true;
+        options.num_directions = 3;
+        report = gradcheck(loss, {p}, options);
+        print_report(report);
+        std::cout << "(expected 3 directions checked, overall pass)\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/activations.hpp"
+#include "autograd/graph_utils.hpp"
+#include "autograd/tensor.hpp"
+using namespace autograd;
+
+// f = exp(x * y) + exp(y * x) + (x * y) * k, built fresh so each test starts from the same graph.
+std::shared_ptr<Value> build(std::shared_ptr<Value> x, std::shared_ptr<Value> y, std::shared_ptr<Value> k) {
+    auto xy = mult(x, y);
+    return add(add(exp(xy), exp(mult(y, x))), mult(mult(x, y), k));
+}
+
+int main() {
+    std::cout << "=== Test 1: Interned constants ===\n";
+    {
+        std::cout << "same zero node: " << (interned_constant(0.0) == interned_constant(0.0)) << " (expected 1)\n";
+        std::cout << "-0.0 shares it: " << (interned_constant(-0.0) == interned_constant(0.0)) << " (expected 0)\n";
+        std::cout << "3.5 shares it: " << (interned_constant(3.5) == interned_constant(3.5)) << " (expected 0)\n";
+        std::cout << "requires_grad: " << interned_constant(1.0)->requires_grad << " (expected 0)\n";
+        std::cout << "leaf / constant requires_grad: " << leaf(1.0)->requires_grad << " " << constant(1.0)->requires_grad << " (expected 1 1)\n";
+
+        auto a = constant(-2.0);
+        auto b = constant(3.0);
+        auto ra = relu(a);
+        auto rb = relu(b);
+        std::cout << "relu shares its zero: " << (ra->parents[1] == rb->parents[1]) << " (expected 1)\n";
+        backward(add(ra, rb));
+        std::cout << "a.grad = " << a->grad << " (expected 0)\n";
+        std::cout << "b.grad = " << b->grad << " (expected 1)\n";
+        std::cout << "pooled zero grad = " << interned_constant(0.0)->grad << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 2: Folding at op time ===\n";
+    {
+        auto c = mult(add(interned_constant(2.0), interned_constant(0.5)), interned_constant(4.0));
+        std::cout << "c = " << c->value << " (expected 10)\n";
+        std::cout << "c parents: " << c->parents.size() << " (expected 0)\n";
+        std::cout << "c requires_grad: " << c->requires_grad << " (expected 0)\n";
+
+        auto x = constant(3.0);
+        auto y = mult(x, c);
+        backward(y);
+        std::cout << "x.grad = " << x->grad << " (expected 10)\n";
+
+        auto A = create_tensor({1.0, 2.0, 3.0, 4.0}, 2, 2, false);
+        auto B = create_tensor({0.5, -1.0}, 2, 1, false);
+        auto C = matmul(A, B);
+        std::cout << "constant matmul = " << C->values[0]->value << " " << C->values[1]->value << " (expected -1.5 -2.5)\n";
+        std::cout << "constant matmul parents: " << C->values[0]->parents.size() << " (expected 0)\n";
+        std::cout << "constant matmul requires_grad: " << C->values[0]->requires_grad << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 3: Folding frozen subgraphs ===\n";
+    {
+        // w1 and w2 are frozen after the graph was built, so w1 * w2 + 1 is a constant.
+        auto w1 = constant(2.0);
+        auto w2 = constant(3.0);
+        auto x = constant(0.5);
+        auto scale = add(mult(w1, w2), interned_constant(1.0));
+        auto f = mult(scale, x);
+        w1->requires_grad = false;
+        w2->requires_grad = false;
+
+        auto stats = optimize_graph(f);
+        std::cout << "folded = " << stats.folded << " (expected 2)\n";
+        std::cout << "nodes " << stats.nodes_before << " -> " << stats.nodes_after << " (expected 7 -> 3)\n";
+        std::cout << "scale parents: " << scale->parents.size() << " (expected 0)\n";
+        backward(f);
+        std::cout << "x.grad = " << x->grad << " (expected 7)\n\n";
+    }
+
+    std::cout << "=== Test 4: Common subexpressions ===\n";
+    {
+        auto x1 = constant(0.3), y1 = constant(-0.7), k1 = constant(1.5);
+        auto f1 = build(x1, y1, k1);
+        backward(f1);
+
+        auto x2 = constant(0.3), y2 = constant(-0.7), k2 = constant(1.5);
+        auto f2 = build(x2, y2, k2);
+        auto stats = optimize_graph(f2);
+        std::cout << "deduplicated = " << stats.deduplicated << " (expected 3)\n";
+        std::cout << "nodes " << stats.nodes_before << " -> " << stats.nodes_after << " (expected 11 -> 10)\n";
+        backward(f2);
+        std::cout << "f = " << f2->value << " (expected " << f1->value << ")\n";
+        std::cout << "x.grad = " << x2->grad << " (expected " << x1->grad << ")\n";
+        std::cout << "y.grad = " << y2->grad << " (expected " << y1->grad << ")\n";
+        std::cout << "k.grad = " << k2->grad << " (expected " << k1->grad << ")\n\n";
+    }
+
+    std::cout << "=== Test 5: Optimized graph with grad_graph ===\n";
+    {
+        // f = x*x + x*x = 2x^2: f' = 4x, f'' = 4
+        auto x = constant(1.5);
+        auto f = add(mult(x, x), mult(x, x));
+        auto stats = optimize_graph(f);
+        std::cout << "deduplicated = " << stats.deduplicated << " (expected 1)\n";
+        auto d1 = grad_graph(f, {x})[0];
+        std::cout << "f' = " << d1->value << " (expected 6)\n";
+        backward(d1);
+        std::cout << "f'' = " << x->grad << " (expected 4)\n\n";
+    }
+
+    std::cout << "=== Test 6: Layer with shared inputs ===\n";
+    {
+        // Both branches compute W X + b on the same tensors; only the bias adds are shared.
+        auto W = create_tensor({0.1, -0.2, 0.3, 0.4, 0.5, -0.6}, 2, 3);
+        auto X = create_tensor({1.0, 2.0, 3.0, -1.0, 0.5, 2.0}, 3, 2, false);
+        auto b = create_tensor({0.05, -0.05}, 2, 1);
+        auto h1 = matmul(W, X);
+        auto y1 = addBias(h1, b);
+        auto y2 = addBias(h1, b);
+        auto loss = constant(0.0);
+        for (size_t i = 0; i < y1->values.size(); ++i) {
+            loss = add(loss, mult(y1->values[i], y2->values[i]));
+        }
+        auto stats = optimize_graph(loss);
+        std::cout << "deduplicated = " << stats.deduplicated << " (expected 4)\n";
+        backward(loss);
+        // d/dW of sum (WX + b)^2 = 2 (WX + b) X^T
+        double expected = 0.0;
+        for (int j = 0; j < 2; ++j) {
+            expected += 2.0 * y1->values[j]->value * X->values[j]->value;
+        }
+        std::cout << "dW[0][0] = " << W->values[0]->grad << " (expected " << expected << ")\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/tensor.hpp"
+using namespace autograd;
+
+int main() {
+    std::cout << "=== Test 1: Grad of grad ===\n";
+    {
+        // z = x^2 * y + exp(x)
+        auto x = constant(1.0);
+        auto y = constant(2.0);
+        auto z = add(mult(mult(x, x), y), exp(x));
+
+        auto g = grad_graph(z, {x, y});
+        std::cout << "dz/dx = " << g[0]->value << " (expected " << 4.0 + std::exp(1.0) << ")\n";
+        std::cout << "dz/dy = " << g[1]->value << " (expected 1)\n";
+        std::cout << "x.grad untouched = " << x->grad << " (expected 0)\n";
+
+        backward(g[0]);
+        std::cout << "d2z/dx2 = " << x->grad << " (expected " << 4.0 + std::exp(1.0) << ")\n";
+        std::cout << "d2z/dxdy = " << y->grad << " (expected 2)\n\n";
+    }
+
+    std::cout << "=== Test 2: Third derivative of x^3 ===\n";
+    {
+        // f = x * x * x, f''' = 6
+        auto x = constant(2.0);
+        auto f = mult(mult(x, x), x);
+        auto d1 = grad_graph(f, {x})[0];
+        auto d2 = grad_graph(d1, {x})[0];
+        auto d3 = grad_graph(d2, {x})[0];
+        std::cout << "f' = " << d1->value << " (expected 12)\n";
+        std::cout << "f'' = " << d2->value << " (expected 12)\n";
+        std::cout << "f''' = " << d3->value << " (expected 6)\n\n";
+    }
+
+    std::cout << "=== Test 3: Hessian-vector product ===\n";
+    {
+        // H = [[2y + e^x, 2x], [2x, 0]] at (1, 2)
+        auto x = constant(1.0);
+        auto y = constant(2.0);
+        auto z = add(mult(mult(x, x), y), exp(x));
+
+        auto Hv = hvp(z, {x, y}, {1.0, 1.0});
+        std::cout << "Hv = " << Hv[0] << " " << Hv[1] << " (expected " << 6.0 + std::exp(1.0) << " 2)\n";
+        std::cout << "grad after hvp = " << x->grad << " " << y->grad << " (expected 0 0)\n\n";
+    }
+
+    std::cout << "=== Test 4: HVP through matmul, division and log ===\n";
+    {
+        // loss = log(w0 * x0 + w1 * x1) / w0, compared against a finite difference of the gradient
+        auto w = create_tensor({0.7, 1.3}, 1, 2);
+        auto xs = create_tensor({2.0, 3.0}, 2, 1);
+        auto grad_at = [&](double w0, double w1, double& g0, double& g1) {
+            w->values[0]->value = w0;
+            w->values[1]->value = w1;
+            w->values[0]->grad = 0.0;
+            w->values[1]->grad = 0.0;
+            backward(div(log(matmul(w, xs)->values[0]), w->values[0]));
+            g0 = w->values[0]->grad;
+            g1 = w->values[1]->grad;
+        };
+        double gp0, gp1, gm0, gm1;
+        double eps = 1e-5;
+        grad_at(0.7 + eps * 0.5, 1.3 - eps, gp0, gp1);
+        grad_at(0.7 - eps * 0.5, 1.3 + eps, gm0, gm1);
+        w->values[0]->value = 0.7;
+        w->values[1]->value = 1.3;
+        auto loss = div(log(matmul(w, xs)->values[0]), w->values[0]);
+        auto Hv = hvp(loss, w->values, {0.5, -1.0});
+        std::cout << "Hv = " << Hv[0] << " " << Hv[1] << "\n";
+        std::cout << "fd = " << (gp0 - gm0) / (2 * eps) << " " << (gp1 - gm1) / (2 * eps) << " (should match)\n\n";
+    }
+
+    std::cout << "=== Test 5: Repeated hvp leaves the graph as it was ===\n";
+    {
+        // z = x^2 * y + x * k with k a leaf that is not a param; H v with v = (1, 0) is (2y, 2x).
+        auto x = constant(1.0);
+        auto y = constant(2.0);
+        auto k = constant(3.0);
+        auto z = add(mult(mult(x, x), y), mult(x, k));
+        backward(z);
+        double x_grad = x->grad, y_grad = y->grad, k_grad = k->grad;
+        std::vector<double> Hv;
+        for (int call = 0; call < 5; ++call) {
+            Hv = hvp(z, {x, y}, {1.0, 0.0});
+        }
+        std::cout << "Hv after 5 calls = " << Hv[0] << " " << Hv[1] << " (expected 4 2)\n";
+        bool unchanged = x->grad == x_grad && y->grad == y_grad && k->grad == k_grad;
+        std::cout << "grads unchanged: " << unchanged << " (expected 1)\n";
+    }
+
+    return 0;
+}
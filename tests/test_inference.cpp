@@ -0,0 +1,125 @@
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/activations.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/inference.hpp"
+using namespace autograd;
+
+int main() {
+    // Same layer as test_nn.cpp, followed by a 1x2 readout.
+    auto weights = create_tensor({0.2, 0.8, -0.5, 1.0}, 2, 2);
+    auto bias = create_tensor({0.5, -1.0}, 2, 1);
+    auto readout = create_tensor({1.5, -2.0}, 1, 2);
+    auto readout_bias = create_tensor({0.25}, 1, 1);
+
+    Model model;
+    model.layers.push_back(dense_layer(weights, bias, true));
+    model.layers.push_back(dense_layer(readout, readout_bias));
+
+    auto reference = [&](double a, double b) {
+        auto x = create_tensor({(float)a, (float)b}, 2, 1, false);
+        auto h = addBias(matmul(weights, x), bias);
+        auto hidden = std::make_shared<Tensor>(Tensor{{relu(h->values[0]), relu(h->values[1])}, {2, 1}});
+        return addBias(matmul(readout, hidden), readout_bias)->values[0]->value;
+    };
+
+    std::cout << "=== Test 1: Graph-free forward matches the graph ===\n";
+    {
+        auto y = forward_batch(model, {1.0, 2.0, -1.0, 0.5}, 2);
+        std::cout << "y = " << y[0] << " " << y[1] << "\n";
+        std::cout << "graph y = " << reference(1.0, 2.0) << " " << reference(-1.0, 0.5) << " (should match)\n\n";
+    }
+
+    std::cout << "=== Test 2: Save / load round trip ===\n";
+    {
+        const char* path = "test_inference_model.txt";
+        save_model(model, path);
+        auto loaded = load_model(path);
+        std::remove(path);
+        auto a = forward_batch(model, {0.3, -0.7}, 1);
+        auto b = forward_batch(loaded, {0.3, -0.7}, 1);
+        std::cout << "layers = " << loaded.layers.size() << " (expected 2)\n";
+        std::cout << "same output = " << (a == b) << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 3: Concurrent requests through the engine ===\n";
+    {
+        EngineOptions options;
+        options.max_batch_size = 8;
+        options.max_wait = std::chrono::microseconds(2000);
+        InferenceEngine engine(model, options);
+
+        const int clients = 4, per_client = 200;
+        int mismatches = 0;
+        auto threads = std::vector<std::thread>();
+        auto errors = std::vector<int>(clients, 0);
+        for (int c = 0; c < clients; ++c) {
+            threads.emplace_back([&, c]() {
+                // Submit in bursts so the engine has something to batch.
+                for (int r = 0; r < per_client; r += 10) {
+                    auto futures = std::vector<std::future<std::vector<double>>>();
+                    for (int i = 0; i < 10; ++i) {
+                        double a = 0.01 * (c * per_client + r + i);
+                        futures.push_back(engine.submit({a, -a}));
+                    }
+                    for (int i = 0; i < 10; ++i) {
+                        double a = 0.01 * (c * per_client + r + i);
+                        auto expected = forward_batch(model, {a, -a}, 1);
+                        if (futures[i].get() != expected) {
+                            errors[c]++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        for (int e : errors) mismatches += e;
+
+        auto stats = engine.stats();
+        uint64_t histogram_total = 0, batched = 0;
+        for (size_t size = 0; size < stats.batch_size_histogram.size(); ++size) {
+            histogram_total += size * stats.batch_size_histogram[size];
+            if (size > 1) batched += stats.batch_size_histogram[size];
+        }
+        std::cout << "mismatches = " << mismatches << " (expected 0)\n";
+        std::cout << "requests = " << stats.requests << " (expected 800)\n";
+        std::cout << "histogram covers all requests = " << (histogram_total == stats.requests) << " (expected 1)\n";
+        std::cout << "batches larger than 1 = " << (batched > 0) << " (expected 1)\n";
+        std::cout << "p50 <= p99 = " << (stats.p50_latency_us <= stats.p99_latency_us) << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 4: Bad request size ===\n";
+    {
+        InferenceEngine engine(model);
+        try {
+            engine.submit({1.0}).get();
+            std::cout << "no error (expected an exception)\n";
+        } catch (const std::invalid_argument& e) {
+            std::cout << "rejected: " << e.what() << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "=== Test 5: Models the engine cannot serve ===\n";
+    {
+        auto zero_output = model;
+        zero_output.layers.back().out_features = 0;
+        zero_output.layers.back().weight.clear();
+        zero_output.layers.back().bias.clear();
+        for (auto& bad : {Model{}, zero_output}) {
+            try {
+                InferenceEngine engine(bad);
+                std::cout << "accepted (expected invalid_argument)\n";
+            } catch (const std::invalid_argument& e) {
+                std::cout << "rejected: " << e.what() << "\n";
+            }
+        }
+    }
+
+    return 0;
+}
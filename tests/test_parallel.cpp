@@ -0,0 +1,123 @@
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/grad_mode.hpp"
+#include "autograd/parallel.hpp"
+using namespace autograd;
+
+std::vector<float> random_data(int n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    auto data = std::vector<float>(n);
+    for (auto& v : data) v = dist(rng);
+    return data;
+}
+
+// Forward + backward of sum(A B + bias), returning C, dA and dB flattened.
+std::vector<double> run_layer(int M, int K, int N) {
+    auto A = create_tensor(random_data(M * K, 1), M, K);
+    auto B = create_tensor(random_data(K * N, 2), K, N);
+    auto bias = create_tensor(random_data(M, 3), M, 1);
+    auto C = addBias(matmul(A, B), bias);
+    auto loss = C->values[0];
+    for (size_t i = 1; i < C->values.size(); ++i) {
+        loss = add(loss, mult(C->values[i], C->values[i]));
+    }
+    backward(loss);
+    auto out = std::vector<double>();
+    for (auto& v : C->values) out.push_back(v->value);
+    for (auto& v : A->values) out.push_back(v->grad);
+    for (auto& v : B->values) out.push_back(v->grad);
+    return out;
+}
+
+int main() {
+    std::cout << "=== Test 1: parallel_for covers the range once ===\n";
+    {
+        set_num_threads(4);
+        auto hits = std::vector<int>(10000, 0);
+        parallel_for(0, 10000, 16, [&](int64_t first, int64_t last) {
+            for (int64_t i = first; i < last; ++i) hits[i]++;
+        });
+        int wrong = 0;
+        for (int h : hits) wrong += h != 1;
+        std::cout << "threads = " << get_num_threads() << " (expected 4)\n";
+        std::cout << "elements not hit exactly once = " << wrong << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 2: parallel_reduce ===\n";
+    {
+        auto sum = parallel_reduce<int64_t>(1, 100001, 100, 0,
+            [](int64_t first, int64_t last) {
+                int64_t s = 0;
+                for (int64_t i = first; i < last; ++i) s += i;
+                return s;
+            },
+            [](int64_t a, int64_t b) { return a + b; });
+        std::cout << "sum 1..100000 = " << sum << " (expected 5000050000)\n\n";
+    }
+
+    std::cout << "=== Test 3: Large matmul matches the serial run ===\n";
+    {
+        set_num_threads(1);
+        auto serial = run_layer(96, 80, 64);
+        set_num_threads(4);
+        auto parallel = run_layer(96, 80, 64);
+        std::cout << "identical values and gradients = " << (serial == parallel) << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 4: Workers inherit no-grad mode ===\n";
+    {
+        auto A = create_tensor(random_data(128 * 128, 4), 128, 128);
+        NoGradGuard no_grad;
+        auto C = matmul(A, A);
+        int recorded = 0;
+        for (auto& v : C->values) recorded += !v->parents.empty();
+        std::cout << "outputs with parents = " << recorded << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 5: Exceptions reach the caller ===\n";
+    {
+        try {
+            parallel_for(0, 1000, 1, [](int64_t first, int64_t) {
+                if (first == 0) throw std::runtime_error("chunk failed");
+            });
+            std::cout << "no exception (expected one)\n";
+        } catch (const std::runtime_error& e) {
+            std::cout << "caught: " << e.what() << " (expected chunk failed)\n";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "=== Test 6: Matmul only sees outputs reached by the current pass ===\n";
+    {
+        // Y[1] keeps its gradient from the first backward(); the second pass only reaches Y[0].
+        auto W = create_tensor({1.0, 2.0, 3.0, 4.0}, 2, 2);
+        auto X = create_tensor({1.0, 1.0}, 2, 1, false);
+        auto Y = matmul(W, X);
+        backward(Y->values[1]);
+        for (auto& w : W->values) w->grad = 0.0;
+        backward(Y->values[0]);
+        std::cout << "dW = " << W->values[0]->grad << " " << W->values[1]->grad << " " << W->values[2]->grad << " " << W->values[3]->grad << " (expected 1 1 0 0)\n\n";
+    }
+
+    std::cout << "=== Test 7: Scoped thread count ===\n";
+    {
+        set_num_threads(2);
+        int inside = 0, other = 0;
+        {
+            NumThreadsGuard guard(3);
+            inside = get_num_threads();
+            std::thread([&]() { other = get_num_threads(); }).join();
+        }
+        std::cout << "inside guard = " << inside << ", other thread = " << other << ", after = " << get_num_threads() << " (expected 3, 2, 2)\n";
+    }
+
+    return 0;
+}
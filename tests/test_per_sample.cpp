@@ -0,0 +1,134 @@
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/activations.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/per_sample.hpp"
+using namespace autograd;
+
+const int batch = 4;
+
+struct Net {
+    std::shared_ptr<Tensor> W1 = create_tensor({0.3, -0.2, 0.5, 0.1, -0.4, 0.7}, 3, 2);
+    std::shared_ptr<Tensor> b1 = create_tensor({0.1, -0.1, 0.2}, 3, 1);
+    std::shared_ptr<Tensor> W2 = create_tensor({0.6, -0.5, 0.4}, 1, 3);
+    std::shared_ptr<Tensor> b2 = create_tensor({0.05}, 1, 1);
+};
+
+struct Forward {
+    std::shared_ptr<Tensor> X, Y1, H, Y2;
+    std::vector<std::shared_ptr<Value>> losses;   // one squared error per column
+};
+
+Forward forward(const Net& net, const std::vector<float>& x, const std::vector<float>& t, int n) {
+    Forward f;
+    f.X = create_tensor(x, 2, n, false);
+    f.Y1 = addBias(matmul(net.W1, f.X), net.b1);
+    f.H = std::make_shared<Tensor>();
+    f.H->shape = f.Y1->shape;
+    for (auto& v : f.Y1->values) {
+        f.H->values.push_back(relu(v));
+    }
+    f.Y2 = addBias(matmul(net.W2, f.H), net.b2);
+    for (int j = 0; j < n; ++j) {
+        auto d = sub(f.Y2->values[j], interned_constant(t[j]));
+        f.losses.push_back(mult(d, d));
+    }
+    return f;
+}
+
+std::vector<std::shared_ptr<Value>> params(const Net& net) {
+    auto out = std::vector<std::shared_ptr<Value>>();
+    for (auto& t : {net.W1, net.b1, net.W2, net.b2}) {
+        out.insert(out.end(), t->values.begin(), t->values.end());
+    }
+    return out;
+}
+
+int main() {
+    std::cout << "=== Test 1: Jacobian ===\n";
+    {
+        // outputs (x * y, x + y, exp(x)) at (2, 3)
+        auto x = constant(2.0);
+        auto y = constant(3.0);
+        auto J = jacobian({mult(x, y), add(x, y), exp(x)}, {x, y});
+        std::cout << "J[0] = " << J[0][0] << " " << J[0][1] << " (expected 3 2)\n";
+        std::cout << "J[1] = " << J[1][0] << " " << J[1][1] << " (expected 1 1)\n";
+        std::cout << "J[2] = " << J[2][0] << " " << J[2][1] << " (expected " << std::exp(2.0) << " 0)\n";
+        std::cout << "x.grad = " << x->grad << " (expected 0)\n\n";
+    }
+
+    Net net;
+    auto x = std::vector<float>{1.0, -0.5, 2.0, 0.3, 0.5, 1.5, -1.0, 0.8};   // (2, batch)
+    auto t = std::vector<float>{0.2, -0.3, 0.5, 1.0};
+
+    // Reference: a separate graph and backward() per sample.
+    auto reference = std::vector<std::vector<double>>();
+    for (int j = 0; j < batch; ++j) {
+        auto f = forward(net, {x[j], x[batch + j]}, {t[j]}, 1);
+        auto p = params(net);
+        for (auto& v : p) {
+            v->grad = 0.0;
+        }
+        backward(f.losses[0]);
+        auto row = std::vector<double>();
+        for (auto& v : p) {
+            row.push_back(v->grad);
+            v->grad = 0.0;
+        }
+        reference.push_back(row);
+    }
+
+    std::cout << "=== Test 2: Per-sample gradients via jacobian ===\n";
+    {
+        auto f = forward(net, x, t, batch);
+        auto J = jacobian(f.losses, params(net));
+        double max_diff = 0.0;
+        for (int j = 0; j < batch; ++j) {
+            for (size_t p = 0; p < J[j].size(); ++p) {
+                max_diff = std::max(max_diff, std::abs(J[j][p] - reference[j][p]));
+            }
+        }
+        std::cout << "matches per-sample backward: " << (max_diff < 1e-12) << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 3: Linear layers by outer products ===\n";
+    {
+        auto f = forward(net, x, t, batch);
+        auto g = per_sample_linear_grads(f.losses, {{f.X, f.Y1}, {f.H, f.Y2}});
+        std::cout << "layer shapes: " << g[0].out_features << "x" << g[0].in_features << ", " << g[1].out_features << "x" << g[1].in_features << " (expected 3x2, 1x3)\n";
+        double max_diff = 0.0;
+        for (int j = 0; j < batch; ++j) {
+            // Reference order: W1 (6), b1 (3), W2 (3), b2 (1).
+            auto ours = std::vector<double>();
+            ours.insert(ours.end(), g[0].weight.begin() + j * 6, g[0].weight.begin() + (j + 1) * 6);
+            ours.insert(ours.end(), g[0].bias.begin() + j * 3, g[0].bias.begin() + (j + 1) * 3);
+            ours.insert(ours.end(), g[1].weight.begin() + j * 3, g[1].weight.begin() + (j + 1) * 3);
+            ours.push_back(g[1].bias[j]);
+            for (size_t p = 0; p < ours.size(); ++p) {
+                max_diff = std::max(max_diff, std::abs(ours[p] - reference[j][p]));
+            }
+        }
+        std::cout << "matches per-sample backward: " << (max_diff < 1e-12) << " (expected 1)\n";
+        std::cout << "W1.grad untouched: " << net.W1->values[0]->grad << " (expected 0)\n";
+
+        // The per-sample gradients add up to the batch gradient.
+        auto total = constant(0.0);
+        for (auto& l : f.losses) {
+            total = add(total, l);
+        }
+        backward(total);
+        double sum = 0.0;
+        for (int j = 0; j < batch; ++j) {
+            sum += g[1].weight[j * 3 + 1];
+        }
+        std::cout << "sum of dW2[0][1] = " << sum << " (expected " << net.W2->values[1]->grad << ")\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <random>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/quantize.hpp"
+using namespace autograd;
+
+std::vector<float> random_data(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    auto data = std::vector<float>(n);
+    for (auto& v : data) v = dist(rng);
+    return data;
+}
+
+int main() {
+    std::mt19937 rng(42);
+    const int in = 40, out = 16, batch = 8;
+    auto weight = create_tensor(random_data(out * in, rng), out, in, false);
+    auto bias = create_tensor(random_data(out, rng), out, 1, false);
+    auto X = create_tensor(random_data(in * batch, rng), in, batch, false);
+
+    std::cout << "=== Test 1: Kernels agree bit for bit ===\n";
+    {
+        auto best = detect_int8_kernel();
+        std::cout << "best kernel = " << int8_kernel_name(best) << "\n";
+        auto A = std::vector<int8_t>(3 * 64);
+        auto W = std::vector<int8_t>(5 * 64);
+        std::uniform_int_distribution<int> q(-127, 127);
+        for (auto& v : A) v = (int8_t)q(rng);
+        for (auto& v : W) v = (int8_t)q(rng);
+        auto sums = std::vector<int32_t>(5, 0);
+        for (int n = 0; n < 5; ++n)
+            for (int k = 0; k < 64; ++k) sums[n] += W[n * 64 + k];
+
+        auto ref = std::vector<int32_t>(15);
+        int8_gemm(A.data(), W.data(), sums.data(), ref.data(), 3, 5, 64, Int8Kernel::Scalar);
+        for (auto kernel : {Int8Kernel::AVX2, Int8Kernel::VNNI}) {
+            if ((int)kernel > (int)best) continue;
+            auto C = std::vector<int32_t>(15);
+            int8_gemm(A.data(), W.data(), sums.data(), C.data(), 3, 5, 64, kernel);
+            std::cout << int8_kernel_name(kernel) << " matches scalar = " << (C == ref) << " (expected 1)\n";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "=== Test 2: Quantized Linear vs double matmul ===\n";
+    {
+        auto layer = quantize_linear(weight, bias, {X}, true);
+        auto Y = quantized_forward(layer, X);
+        auto ref = addBias(matmul(weight, X), bias);
+
+        double max_err = 0.0, max_ref = 0.0;
+        for (size_t i = 0; i < Y->values.size(); ++i) {
+            double r = std::max(0.0, ref->values[i]->value);
+            max_err = std::max(max_err, std::abs(Y->values[i]->value - r));
+            max_ref = std::max(max_ref, std::abs(r));
+        }
+        std::cout << "output shape = (" << Y->shape[0] << ", " << Y->shape[1] << ") (expected (16, 8))\n";
+        std::cout << "max abs error = " << max_err << " of max |y| = " << max_ref << " (expected error below 2% of max |y|)\n";
+        std::cout << "records graph = " << (!Y->values[0]->parents.empty() || Y->values[0]->requires_grad) << " (expected 0)\n";
+        std::cout << "weight bytes = " << layer.weight.size() << " int8 vs " << out * in * sizeof(double) << " double\n\n";
+    }
+
+    std::cout << "=== Test 3: Requantized int8 output feeds the next layer ===\n";
+    {
+        auto layer1 = quantize_linear(weight, bias, {X}, true);
+        auto hidden = addBias(matmul(weight, X), bias);
+        for (auto& v : hidden->values) v->value = std::max(0.0, v->value);
+
+        auto weight2 = create_tensor(random_data(4 * out, rng), 4, out, false);
+        auto bias2 = create_tensor(random_data(4, rng), 4, 1, false);
+        auto layer2 = quantize_linear(weight2, bias2, {hidden}, false);
+
+        auto x = std::vector<float>(batch * in);
+        for (int k = 0; k < in; ++k)
+            for (int m = 0; m < batch; ++m) x[m * in + k] = (float)X->values[k * batch + m]->value;
+        auto h_q = quantized_forward_int8(layer1, quantize_input(layer1, x, batch), batch, layer2.input_scale);
+
+        auto y = quantized_forward(layer2, h_q, batch);
+
+        auto ref = addBias(matmul(weight2, hidden), bias2);
+        double max_err = 0.0;
+        for (int o = 0; o < 4; ++o)
+            for (int m = 0; m < batch; ++m)
+                max_err = std::max(max_err, std::abs((double)y[m * 4 + o] - ref->values[o * batch + m]->value));
+        std::cout << "two-layer max abs error = " << max_err << " (expected below 0.1)\n";
+    }
+
+    return 0;
+}
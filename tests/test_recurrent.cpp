@@ -0,0 +1,206 @@
+#include <iostream>
+#include <memory>
+#include <cmath>
+#include <stdexcept>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/constant.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/optim.hpp"
+#include "autograd/gradcheck.hpp"
+#include "autograd/recurrent.hpp"
+using namespace autograd;
+
+// sum_k w_k * t_k with fixed weights, so every output element gets a distinct gradient.
+std::shared_ptr<Value> weighted_sum(const std::shared_ptr<Tensor>& t, double scale) {
+    auto out = mult(t->values[0], constant(scale));
+    for (size_t k = 1; k < t->values.size(); ++k) {
+        out = add(out, mult(t->values[k], constant(scale * (1.0 + 0.3 * k))));
+    }
+    return out;
+}
+
+std::shared_ptr<Tensor> sequence_input(int t, int in, int batch) {
+    auto data = std::vector<float>();
+    for (int k = 0; k < in * batch; ++k) {
+        data.push_back((float)std::sin(0.1 * t + 0.7 * k));
+    }
+    return create_tensor(data, in, batch, false);
+}
+
+int main() {
+    const int in = 3, hidden = 4, batch = 2;
+
+    std::cout << "=== Test 1: LSTM step gradients ===\n";
+    {
+        auto cell = lstm_cell(in, hidden, 1);
+        auto x0 = create_tensor({0.5, -0.2, 0.1, 0.9, -0.7, 0.3}, in, batch);
+        auto x1 = create_tensor({-0.4, 0.6, 0.2, -0.1, 0.8, -0.5}, in, batch);
+        auto h0 = create_tensor({0.1, -0.3, 0.2, 0.05, -0.1, 0.4, 0.0, 0.2}, hidden, batch);
+        auto c0 = create_tensor({-0.2, 0.1, 0.3, -0.4, 0.2, 0.0, 0.1, -0.1}, hidden, batch);
+        // Two chained steps so gradients also flow through the carried h and c.
+        auto fn = [](const std::vector<std::shared_ptr<Tensor>>& t) {
+            LSTMCell c{3, 4, t[0], t[1]};
+            auto s = lstm_step(c, t[2], {t[4], t[5]});
+            s = lstm_step(c, t[3], s);
+            return add(weighted_sum(s.h, 1.0), weighted_sum(s.c, 0.5));
+        };
+        auto report = gradcheck(fn, {cell.W, cell.b, x0, x1, h0, c0});
+        std::cout << "gradcheck W, b, x, h, c: " << (report.passed ? "PASS" : "FAIL") << " (expected PASS)\n\n";
+    }
+
+    std::cout << "=== Test 2: GRU step gradients ===\n";
+    {
+        auto cell = gru_cell(in, hidden, 2);
+        auto x0 = create_tensor({0.5, -0.2, 0.1, 0.9, -0.7, 0.3}, in, batch);
+        auto x1 = create_tensor({-0.4, 0.6, 0.2, -0.1, 0.8, -0.5}, in, batch);
+        auto h0 = create_tensor({0.1, -0.3, 0.2, 0.05, -0.1, 0.4, 0.0, 0.2}, hidden, batch);
+        auto fn = [](const std::vector<std::shared_ptr<Tensor>>& t) {
+            GRUCell c{3, 4, t[0], t[1]};
+            auto h = gru_step(c, t[2], t[4]);
+            h = gru_step(c, t[3], h);
+            return weighted_sum(h, 1.0);
+        };
+        auto report = gradcheck(fn, {cell.W, cell.b, x0, x1, h0});
+        std::cout << "gradcheck W, b, x, h: " << (report.passed ? "PASS" : "FAIL") << " (expected PASS)\n";
+
+        backward(fn({cell.W, cell.b, x0, x1, h0}));
+        // Row 2H is [W_in 0]: its hidden half is a structural zero.
+        double zero_block_grad = 0.0;
+        for (int k = in; k < in + hidden; ++k) {
+            zero_block_grad += std::abs(cell.W->values[2 * hidden * (in + hidden) + k]->grad);
+        }
+        std::cout << "zero block grad = " << zero_block_grad << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 3: Long unrolled sequence ===\n";
+    {
+        // One window over the whole sequence: the graph is thousands of steps deep.
+        const int steps = 3000;
+        auto cell = gru_cell(1, 2, 3);
+        auto inputs = std::vector<std::shared_ptr<Tensor>>();
+        for (int t = 0; t < steps; ++t) {
+            inputs.push_back(sequence_input(t, 1, 1));
+        }
+        auto h = gru_zero_state(cell, 1);
+        auto loss_fn = [&](int t, std::shared_ptr<Tensor> h) -> std::shared_ptr<Value> {
+            return t == steps - 1 ? mult(h->values[0], h->values[0]) : nullptr;
+        };
+        truncated_bptt(cell, inputs, h, steps, loss_fn);
+        double norm = 0.0;
+        for (auto& v : cell.W->values) {
+            norm += v->grad * v->grad;
+        }
+        std::cout << "backward through " << steps << " steps finite: " << std::isfinite(norm) << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 4: Truncated BPTT training ===\n";
+    {
+        // Predict the next value of a sine wave from the current one.
+        const int steps = 200, window = 20;
+        auto cell = lstm_cell(1, 8, 4);
+        auto readout = create_tensor(std::vector<float>(8, 0.1f), 1, 8);
+        auto inputs = std::vector<std::shared_ptr<Tensor>>();
+        for (int t = 0; t <= steps; ++t) {
+            inputs.push_back(create_tensor({(float)std::sin(0.2 * t)}, 1, 1, false));
+        }
+        auto sequence = std::vector<std::shared_ptr<Tensor>>(inputs.begin(), inputs.end() - 1);
+
+        std::weak_ptr<Value> first_step;
+        int windows = 0;
+        auto loss_fn = [&](int t, std::shared_ptr<Tensor> h) {
+            if (t == 0) {
+                first_step = h->values[0];
+            }
+            auto y = matmul(readout, h)->values[0];
+            auto d = sub(y, interned_constant(inputs[t + 1]->values[0]->value));
+            return mult(d, d);
+        };
+        auto on_window_end = [&](int, int, double) {
+            windows += 1;
+            sgd_step(cell.W, 0.05);
+            sgd_step(cell.b, 0.05);
+            sgd_step(readout, 0.05);
+            zero_grad(cell.W);
+            zero_grad(cell.b);
+            zero_grad(readout);
+        };
+
+        double first_loss = 0.0, last_loss = 0.0;
+        for (int epoch = 0; epoch < 30; ++epoch) {
+            auto state = lstm_zero_state(cell, 1);
+            double loss = truncated_bptt(cell, sequence, state, window, loss_fn, on_window_end);
+            if (epoch == 0) {
+                first_loss = loss;
+                std::cout << "windows per epoch = " << windows << " (expected " << steps / window << ")\n";
+                std::cout << "first window freed: " << first_step.expired() << " (expected 1)\n";
+            }
+            last_loss = loss;
+        }
+        std::cout << "loss decreased: " << (last_loss < 0.5 * first_loss) << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 5: No differentiable backward ===\n";
+    {
+        auto cell = gru_cell(in, hidden, 5);
+        auto h = gru_step(cell, sequence_input(0, in, batch), gru_zero_state(cell, batch));
+        try {
+            grad_graph(weighted_sum(h, 1.0), cell.W->values);
+            std::cout << "no exception (expected runtime_error)\n";
+        } catch (const std::runtime_error&) {
+            std::cout << "caught runtime_error (expected runtime_error)\n";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "=== Test 6: Step only sees outputs reached by the current pass ===\n";
+    {
+        // c' keeps its gradient from the first backward(); the second pass only reaches h'.
+        auto cell = lstm_cell(in, hidden, 6);
+        auto x = sequence_input(0, in, batch);
+        auto state = lstm_step(cell, x, lstm_zero_state(cell, batch));
+        backward(weighted_sum(state.c, 1.0));
+        zero_grad(cell.W);
+        backward(weighted_sum(state.h, 1.0));
+        auto after_stale = std::vector<double>();
+        for (auto& w : cell.W->values) after_stale.push_back(w->grad);
+
+        zero_grad(cell.W);
+        auto fresh = lstm_step(cell, x, lstm_zero_state(cell, batch));
+        backward(weighted_sum(fresh.h, 1.0));
+        bool same = true;
+        for (size_t k = 0; k < after_stale.size(); ++k) {
+            same = same && after_stale[k] == cell.W->values[k]->grad;
+        }
+        std::cout << "dW matches a fresh graph: " << same << " (expected 1)\n\n";
+    }
+
+    std::cout << "=== Test 7: Plain RNN step gradients and truncated BPTT ===\n";
+    {
+        auto cell = rnn_cell(in, hidden, 7);
+        auto x0 = create_tensor({0.5, -0.2, 0.1, 0.9, -0.7, 0.3}, in, batch);
+        auto x1 = create_tensor({-0.4, 0.6, 0.2, -0.1, 0.8, -0.5}, in, batch);
+        auto h0 = create_tensor({0.1, -0.3, 0.2, 0.05, -0.1, 0.4, 0.0, 0.2}, hidden, batch);
+        auto fn = [](const std::vector<std::shared_ptr<Tensor>>& t) {
+            RNNCell c{3, 4, t[0], t[1]};
+            auto h = rnn_step(c, t[2], t[4]);
+            h = rnn_step(c, t[3], h);
+            return weighted_sum(h, 1.0);
+        };
+        auto report = gradcheck(fn, {cell.W, cell.b, x0, x1, h0});
+        std::cout << "gradcheck W, b, x, h: " << (report.passed ? "PASS" : "FAIL") << " (expected PASS)\n";
+
+        auto inputs = std::vector<std::shared_ptr<Tensor>>();
+        for (int t = 0; t < 12; ++t) {
+            inputs.push_back(sequence_input(t, in, batch));
+        }
+        auto h = rnn_zero_state(cell, batch);
+        int windows = 0;
+        auto loss_fn = [](int, std::shared_ptr<Tensor> h) { return weighted_sum(h, 0.1); };
+        truncated_bptt(cell, inputs, h, 5, loss_fn, [&](int, int, double) { windows += 1; });
+        std::cout << "windows = " << windows << ", final h detached: " << h->values[0]->parents.empty() << " (expected 3, 1)\n";
+    }
+
+    return 0;
+}
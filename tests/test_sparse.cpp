@@ -0,0 +1,106 @@
+#include <iostream>
+#include <memory>
+#include "autograd/value.hpp"
+#include "autograd/ops.hpp"
+#include "autograd/backward.hpp"
+#include "autograd/tensor.hpp"
+#include "autograd/sparse.hpp"
+#include "autograd/optim.hpp"
+#include "autograd/grad_mode.hpp"
+using namespace autograd;
+
+int main() {
+    std::cout << "=== Test 1: Sparse x dense matmul ===\n";
+    {
+        // A = [[2, 0, 0],
+        //      [0, 0, 0],
+        //      [1, 0, 3]]
+        auto A = create_sparse_coo({2, 0, 2}, {0, 0, 2}, {1.0, 2.0, 3.0}, 3, 3);
+        auto B = create_tensor({1, 2, 3, 4, 5, 6}, 3, 2);
+
+        auto C = matmul(A, B);
+        std::cout << "C = ";
+        for (const auto& v : C->values) std::cout << v->value << " ";
+        std::cout << "(expected 2 4 0 0 16 20)\n";
+
+        auto loss = add(add(C->values[0], C->values[3]), add(C->values[4], C->values[5]));
+        backward(loss);
+
+        std::cout << "dA = ";
+        for (const auto& v : A->values) std::cout << v->grad << " ";
+        std::cout << "(expected 3 1 11)\n";
+        std::cout << "dB = ";
+        for (const auto& v : B->values) std::cout << v->grad << " ";
+        std::cout << "(expected 3 1 0 0 3 3)\n\n";
+    }
+
+    std::cout << "=== Test 2: Sparse matches dense gradients ===\n";
+    {
+        auto dense = create_tensor({0, 1.5, 0, -2, 0, 0, 0, 4}, 2, 4);
+        auto B = create_tensor({1, 2, 3, 4, 5, 6, 7, 8}, 4, 2);
+        auto sparse = to_csr(sparse_from_dense(dense));
+        std::cout << "nnz = " << sparse->values.size() << " (expected 3)\n";
+
+        auto C = matmul(sparse, B);
+        backward(add(add(C->values[0], C->values[1]), add(C->values[2], C->values[3])));
+        std::cout << "sparse dB = ";
+        for (const auto& v : B->values) std::cout << v->grad << " ";
+        std::cout << "\n";
+        std::cout << "sparse dA = ";
+        for (const auto& v : dense->values) std::cout << v->grad << " ";
+        std::cout << "\n";
+
+        auto dense_ref = create_tensor({0, 1.5, 0, -2, 0, 0, 0, 4}, 2, 4);
+        auto B_ref = create_tensor({1, 2, 3, 4, 5, 6, 7, 8}, 4, 2);
+        auto C_ref = matmul(dense_ref, B_ref);
+        backward(add(add(C_ref->values[0], C_ref->values[1]), add(C_ref->values[2], C_ref->values[3])));
+        std::cout << "dense  dB = ";
+        for (const auto& v : B_ref->values) std::cout << v->grad << " ";
+        std::cout << "\n";
+        std::cout << "dense  dA = ";
+        for (const auto& v : dense_ref->values) std::cout << v->grad << " ";
+        std::cout << "(nonzero entries should match)\n\n";
+    }
+
+    std::cout << "=== Test 3: Embedding lookup with sparse SGD ===\n";
+    {
+        auto table = create_embedding({0, 0, 1, 1, 2, 2, 3, 3, 4, 4}, 5, 2);
+        auto rows = embedding_lookup(table, {1, 3, 1});
+
+        auto loss = rows->values[0];
+        for (size_t i = 1; i < rows->values.size(); ++i) {
+            loss = add(loss, rows->values[i]);
+        }
+        backward(loss);
+
+        auto grad = sparse_grad(table);
+        std::cout << "touched rows = ";
+        for (int r : grad.rows) std::cout << r << " ";
+        std::cout << "(expected 1 3)\n";
+        std::cout << "row grads = ";
+        for (double g : grad.values) std::cout << g << " ";
+        std::cout << "(expected 2 2 1 1)\n";
+
+        sgd_step(table, 0.5);
+        std::cout << "table = ";
+        for (const auto& v : table->weight->values) std::cout << v->value << " ";
+        std::cout << "(expected 0 0 0 0 2 2 2.5 2.5 4 4)\n";
+        std::cout << "pending rows = " << table->touched_rows.size() << " (expected 0)\n\n";
+    }
+
+    std::cout << "=== Test 4: Embedding lookup under NoGradGuard ===\n";
+    {
+        auto table = create_embedding({0, 0, 1, 1, 2, 2}, 3, 2);
+        {
+            NoGradGuard no_grad;
+            for (int step = 0; step < 100; ++step) {
+                embedding_lookup(table, {0, 2});
+            }
+        }
+        std::cout << "pending rows = " << table->touched_rows.size() << " (expected 0)\n";
+        embedding_lookup(table, {1});
+        std::cout << "pending rows after a recorded lookup = " << table->touched_rows.size() << " (expected 1)\n";
+    }
+
+    return 0;
+}